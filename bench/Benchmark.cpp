@@ -0,0 +1,373 @@
+#include "Graph.h"
+#include "TypedGraph.h"
+#include <chrono>
+#include <random>
+#include <iostream>
+
+using namespace std;
+
+// seconds taken by fn(), best of a few runs
+template <class F>
+double timeIt(F&& fn, int runs = 3)
+{
+	double best = 1e30;
+	for (int r = 0; r < runs; r++)
+	{
+		auto start = chrono::steady_clock::now();
+		fn();
+		chrono::duration<double> taken = chrono::steady_clock::now() - start;
+		if (taken.count() < best)
+			best = taken.count();
+	}
+	return best;
+}
+
+// undirected graph with uniformly random edges, loaded through the bulk-insert path
+AdjList* randomGraph(size_t vertices, size_t edges, unsigned seed)
+{
+	AdjList* adjlist = new AdjList(vertices, false, false);
+	mt19937_64 rng(seed);
+
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	edge_list.reserve(edges);
+	while (edge_list.size() < edges)
+	{
+		size_t u = rng() % vertices, v = rng() % vertices;
+		if (u != v)
+			edge_list.emplace_back(u, v, 1);
+	}
+
+	adjlist->addEdges(edge_list);
+	adjlist->getCSR();
+	return adjlist;
+}
+
+// parallel BFS time for 1, 2, 4, ... threads up to the number of hardware threads
+void benchParallelBFS(AdjList* adjlist)
+{
+	const CSR& g = adjlist->getCSR();
+	const CSR& in = adjlist->getReverseCSR();
+
+	double sequential = timeIt([&] { bfs(g, in, 0); });
+	printf("\nBFS from vertex 0\n");
+	printf("direction-optimizing (1 thread): %.4f s\n\n", sequential);
+	printf("threads\ttime (s)\tspeedup\n");
+
+	size_t max_threads = thread::hardware_concurrency();
+	if (max_threads == 0)
+		max_threads = 1;
+
+	double single = 0;
+	for (size_t threads = 1; ; threads *= 2)
+	{
+		if (threads > max_threads)
+			threads = max_threads;
+
+		ThreadPool pool(threads);
+		double taken = timeIt([&] { parallelBfs(g, 0, pool); });
+		if (threads == 1)
+			single = taken;
+
+		printf("%zu\t%.4f\t\t%.2fx\n", threads, taken, single / taken);
+
+		if (threads == max_threads)
+			break;
+	}
+}
+
+// time to save the graph as a binary CSR file, to map it back, and to load it into an AdjList
+void benchBinaryFile(AdjList* adjlist)
+{
+	const char* path = "graph_benchmark.bin";
+
+	double save = timeIt([&] { adjlist->saveBinary(path); }, 1);
+
+	// mapping copies nothing, but checking the arrays reads every page of the file once
+	double map = timeIt([&]
+	{
+		CSR g;
+		CSRFileHeader header;
+		mapCSRFile(path, g, header);
+	});
+	double trusted = timeIt([&]
+	{
+		CSR g;
+		CSRFileHeader header;
+		mapCSRFile(path, g, header, true);
+	});
+
+	double load = timeIt([&] { delete AdjList::fromBinary(path); }, 1);
+
+	printf("\nBinary CSR file (%zu edges stored)\n", adjlist->getCSR().edgeCount());
+	printf("save: %.4f s\tmap: %.6f s\tmap trusted: %.6f s\tload into AdjList: %.4f s\n", save, map, trusted, load);
+
+	remove(path);
+}
+
+// time to parse the graph written out as a text edge list, and to import it into an AdjList
+void benchTextImport(AdjList* adjlist)
+{
+	const char* path = "graph_benchmark.txt";
+
+	const CSR& g = adjlist->getCSR();
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+		return;
+	fprintf(file, "# random undirected graph\n");
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			if (u < g.targets[e])
+				fprintf(file, "%zu\t%zu\t%zu\n", u, g.targets[e], g.weights[e]);
+	long bytes = ftell(file);
+	fclose(file);
+
+	ImportedGraph imported;
+	double parse = timeIt([&] { importGraph(path, FORMAT_EDGE_LIST, false, defaultThreadPool(), imported); });
+	double load = timeIt([&] { delete AdjList::fromText(path, FORMAT_EDGE_LIST, false); }, 1);
+
+	printf("\nText edge list (%.1f MB, %zu edges)\n", bytes / 1e6, imported.edges.size());
+	printf("parse: %.4f s (%.0f MB/s)\timport into AdjList: %.4f s\n", parse, bytes / 1e6 / parse, load);
+
+	remove(path);
+}
+
+// the same unweighted graph as an AdjList and as a Graph<uint32_t, NoWeight, false>: list and CSR memory, BFS time
+void benchTypedGraph(AdjList* adjlist)
+{
+	const CSR& g = adjlist->getCSR();
+
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	edge_list.reserve(adjlist->edges);
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			if (u < g.targets[e])
+				edge_list.emplace_back(u, g.targets[e], 1);
+
+	Graph<uint32_t, NoWeight, false> typed(g.size());
+	typed.addEdges(edge_list);
+	const GraphCSR<uint32_t, NoWeight>& tg = typed.getCSR();
+
+	size_t stored = g.edgeCount();
+	double adj_bfs = timeIt([&] { bfs(g, g, 0); });
+	double typed_bfs = timeIt([&] { bfs(tg, tg, 0); });
+
+	printf("\nAdjList against Graph<uint32_t, NoWeight, false> (%zu edges stored)\n", stored);
+	printf("\t\tlist nodes (MB)\tCSR (MB)\tBFS (s)\n");
+	printf("AdjList\t\t%.1f\t\t%.1f\t\t%.4f\n", stored * sizeof(ListNode) / 1e6,
+		(stored * 2 * sizeof(size_t) + g.size() * sizeof(size_t)) / 1e6, adj_bfs);
+	printf("Graph\t\t%.1f\t\t%.1f\t\t%.4f\n", stored * sizeof(GraphNode<uint32_t, NoWeight>) / 1e6,
+		(stored * sizeof(uint32_t) + tg.size() * sizeof(size_t)) / 1e6, typed_bfs);
+}
+
+// memory and BFS / DFS time of the graph's CSR against its compressed form
+void benchCompressed(const char* name, AdjList* adjlist)
+{
+	const CSR& g = adjlist->getCSR();
+	const CSR& in = adjlist->getReverseCSR();
+	CompressedCSR cg = adjlist->Compressed();
+	CompressedCSR cin = adjlist->directed ? CompressedCSR(in, false) : CompressedCSR();
+	const CompressedCSR& cin_ref = adjlist->directed ? cin : cg;
+
+	size_t csr_bytes = (g.size() + 1) * sizeof(size_t) + 2 * g.edgeCount() * sizeof(size_t) + g.size();
+	double csr_bfs = timeIt([&] { bfs(g, in, 0); });
+	double csr_dfs = timeIt([&]
+	{
+		DFS dfs(g);
+		dfs.run(0, DFSNoPreHook());
+	});
+	double compressed_bfs = timeIt([&] { bfs(cg, cin_ref, 0); });
+	double compressed_dfs = timeIt([&]
+	{
+		CompressedDFS dfs(cg);
+		dfs.run(0, DFSNoPreHook());
+	});
+
+	printf("\nCompressed adjacency (%s, %s)\n", name, cg.weighted ? "weights kept" : "unweighted");
+	printf("\t\tmemory (MB)\tBFS (s)\t\tDFS (s)\n");
+	printf("CSR\t\t%.1f\t\t%.4f\t\t%.4f\n", csr_bytes / 1e6, csr_bfs, csr_dfs);
+	printf("compressed\t%.1f (%.1fx)\t%.4f (%.2fx)\t%.4f (%.2fx)\n", cg.memoryUsed() / 1e6,
+		(double)csr_bytes / cg.memoryUsed(), compressed_bfs, compressed_bfs / csr_bfs, compressed_dfs, compressed_dfs / csr_dfs);
+}
+
+// hasEdge() on a hub vertex (through its list's hash index) against scanning its CSR row, then removing all its edges
+void benchEdgeLookup(size_t vertices)
+{
+	AdjList hub(vertices, false, false);
+	for (size_t v = 1; v < vertices; v++)
+		hub.addEdge(0, v, 1);
+
+	// both ways answer the same queries (few enough for the row scans to finish in about a second)
+	const size_t queries = 2000;
+	mt19937_64 rng(11);
+	vector<size_t> targets(queries);
+	for (size_t& v : targets)
+		v = rng() % vertices;
+
+	size_t found = 0;
+	double lookup = timeIt([&]
+	{
+		found = 0;
+		for (size_t v : targets)
+			found += hub.hasEdge(0, v);
+	});
+
+	const CSR& g = hub.getCSR();
+	size_t scanned = 0;
+	double scan = timeIt([&]
+	{
+		for (size_t v : targets)
+			scanned += paths_edgeWeight(g, 0, v) != UNREACHABLE;
+	}, 1);
+
+	double removal = timeIt([&]
+	{
+		for (size_t v = 1; v < vertices; v++)
+			hub.removeEdge(0, v);
+	}, 1);
+
+	printf("\nEdge lookup on a vertex of degree %zu (%zu queries)\n", vertices - 1, queries);
+	printf("hasEdge: %.6f s\trow scan: %.4f s\tremove every edge: %.4f s\t(%zu found, %zu by the scan)\n",
+		lookup, scan, removal, found, scanned);
+}
+
+// deleting vertices of a random directed graph: one at a time without and with the in-edge index,
+// and as one batch without it
+void benchVertexDeletion(size_t vertices, size_t edges)
+{
+	const size_t deletions = 50;
+	mt19937_64 rng(13);
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	edge_list.reserve(edges);
+	while (edge_list.size() < edges)
+	{
+		size_t u = rng() % vertices, v = rng() % vertices;
+		if (u != v)
+			edge_list.emplace_back(u, v, 1);
+	}
+
+	vector<size_t> doomed(deletions);
+	for (size_t i = 0; i < deletions; i++)
+		doomed[i] = i * (vertices / deletions);
+
+	double times[3];
+	for (int mode = 0; mode < 3; mode++)
+	{
+		AdjList adjlist(vertices, true, false);
+		adjlist.addEdges(edge_list);
+		if (mode == 1)
+			adjlist.keepInEdges(true);
+
+		times[mode] = timeIt([&]
+		{
+			if (mode == 2)
+				adjlist.removeLists(doomed);
+			else
+				for (size_t u : doomed)
+					adjlist.removeList(u);
+		}, 1);
+	}
+
+	printf("\nDeleting %zu vertices of a random directed graph (%zu vertices, %zu edges)\n", deletions, vertices, edges);
+	printf("one at a time: %.4f s\twith in-edge index: %.4f s\tas one batch (no index): %.4f s\n", times[0], times[1], times[2]);
+}
+
+// weighted square grid of about the given number of vertices, numbered in random order
+// (a grid has plenty of locality to recover, random numbering is what insertion order tends to look like)
+AdjList* shuffledGrid(size_t vertices, unsigned seed)
+{
+	size_t side = 1;
+	while ((side + 1) * (side + 1) <= vertices)
+		side++;
+
+	mt19937_64 rng(seed);
+	vector<size_t> label(side * side);
+	for (size_t i = 0; i < label.size(); i++)
+		label[i] = i;
+	shuffle(label.begin(), label.end(), rng);
+
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	for (size_t r = 0; r < side; r++)
+		for (size_t c = 0; c < side; c++)
+		{
+			size_t u = label[r * side + c];
+			if (c + 1 < side)
+				edge_list.emplace_back(u, label[r * side + c + 1], 1 + rng() % 100);
+			if (r + 1 < side)
+				edge_list.emplace_back(u, label[(r + 1) * side + c], 1 + rng() % 100);
+		}
+
+	AdjList* adjlist = new AdjList(side * side, false, true);
+	adjlist->addEdges(edge_list);
+	return adjlist;
+}
+
+// BFS, a full DFS, Prim and Dijkstra on a shuffled grid, then on its RCM and degree-sorted copies
+void benchReordering(size_t vertices)
+{
+	AdjList* grid = shuffledGrid(vertices, 7);
+	printf("\nVertex reordering (shuffled %zu-vertex grid)\n", grid->vertices);
+	printf("order\t\treorder (s)\tBFS (s)\t\tDFS (s)\t\tPrim (s)\tDijkstra (s)\n");
+
+	auto traverse = [&](const char* name, AdjList* adjlist, double reorder)
+	{
+		const CSR& g = adjlist->getCSR();
+		double bfs_time = timeIt([&] { bfs(g, g, 0); });
+		double dfs_time = timeIt([&]
+		{
+			DFS dfs(g);
+			dfs.run(0, DFSNoPreHook());
+		});
+		double prim_time = timeIt([&] { prim(g, 0); });
+		double dijkstra_time = timeIt([&] { dijkstra(g, 0); });
+		printf("%s\t%.4f\t\t%.4f\t\t%.4f\t\t%.4f\t\t%.4f\n", name, reorder, bfs_time, dfs_time, prim_time, dijkstra_time);
+	};
+
+	traverse("insertion", grid, 0);
+
+	// the RCM copy is kept for the compressed adjacency comparison, which comes after the table
+	const VertexOrdering methods[] = {ORDER_RCM, ORDER_DEGREE};
+	const char* names[] = {"RCM\t", "degree\t"};
+	AdjList* rcm = nullptr;
+	for (int i = 0; i < 2; i++)
+	{
+		vector<size_t> original_id;
+		AdjList* reordered = nullptr;
+		double reorder = timeIt([&]
+		{
+			delete reordered;
+			reordered = grid->Reordered(methods[i], original_id);
+		}, 1);
+		traverse(names[i], reordered, reorder);
+		if (methods[i] == ORDER_RCM)
+			rcm = reordered;
+		else
+			delete reordered;
+	}
+
+	benchCompressed("RCM-ordered grid", rcm);
+	delete rcm;
+	delete grid;
+}
+
+// usage: Graph_Benchmark [vertices] [edges]
+int main(int argc, char** argv)
+{
+	size_t vertices = (argc > 1) ? strtoull(argv[1], nullptr, 10) : 500000;
+	size_t edges = (argc > 2) ? strtoull(argv[2], nullptr, 10) : 8 * vertices;
+
+	printf("Random undirected graph with %zu vertices and %zu edges\n", vertices, edges);
+	AdjList* adjlist = randomGraph(vertices, edges, 42);
+
+	benchParallelBFS(adjlist);
+	benchBinaryFile(adjlist);
+	benchTextImport(adjlist);
+	benchTypedGraph(adjlist);
+	benchCompressed("random graph", adjlist);
+
+	delete adjlist;
+
+	benchReordering(vertices);
+	benchEdgeLookup(vertices);
+	benchVertexDeletion(vertices, edges);
+	return 0;
+}
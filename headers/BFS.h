@@ -0,0 +1,229 @@
+#ifndef BFS_H
+#define BFS_H
+
+#include "CSR.h"
+#include "ShortestPaths.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <utility>
+#include <vector>
+
+// switch from top-down to bottom-up once the frontier has more than 1/BFS_ALPHA of the unexplored edges
+const size_t BFS_ALPHA = 14;
+
+// switch back to top-down once the frontier has less than 1/BFS_BETA of the vertices
+const size_t BFS_BETA = 24;
+
+// one bit per vertex
+class Bitmap
+{
+public:
+	std::vector<uint64_t> words;
+
+	Bitmap(size_t n) : words((n + 63) / 64, 0) {}
+
+	bool get(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+	void set(size_t i) { words[i / 64] |= (uint64_t)1 << (i % 64); }
+	void clear() { words.assign(words.size(), 0); }
+};
+
+// one top-down BFS step: every vertex of the frontier looks at its out-edges for unvisited vertices
+template <class G>
+void bfs_topDownStep(const G& g, ShortestPaths& sp, Bitmap& visited, size_t level,
+	const std::vector<size_t>& frontier, std::vector<size_t>& next, size_t& frontier_edges)
+{
+	next.clear();
+	frontier_edges = 0;
+
+	for (size_t u : frontier)
+		for (typename G::Cursor c = g.row(u); c.next(); )
+		{
+			size_t v = c.vertex;
+			if (visited.get(v))
+				continue;
+
+			visited.set(v);
+			sp.dist[v] = level;
+			sp.parent[v] = u;
+			next.push_back(v);
+			frontier_edges += g.degree(v);
+		}
+}
+
+// one bottom-up BFS step: every unvisited vertex looks at its in-edges for a vertex in the frontier,
+// and stops at the first one it finds
+template <class G>
+void bfs_bottomUpStep(const G& g, const G& in, ShortestPaths& sp, Bitmap& visited, size_t level,
+	const Bitmap& frontier, Bitmap& next, size_t& frontier_size, size_t& frontier_edges)
+{
+	next.clear();
+	frontier_size = 0;
+	frontier_edges = 0;
+
+	size_t n = g.size();
+	for (size_t w = 0; w < visited.words.size(); w++)
+	{
+		// whole words of visited vertices are skipped at once
+		uint64_t unvisited = ~visited.words[w];
+		while (unvisited)
+		{
+			size_t v = w * 64 + std::countr_zero(unvisited);
+			unvisited &= unvisited - 1;
+			if (v >= n)
+				break;
+
+			for (typename G::Cursor c = in.row(v); c.next(); )
+			{
+				size_t u = c.vertex;
+				if (!frontier.get(u))
+					continue;
+
+				visited.set(v);
+				next.set(v);
+				sp.dist[v] = level;
+				sp.parent[v] = u;
+				frontier_size++;
+				frontier_edges += g.degree(v);
+				break;
+			}
+		}
+	}
+}
+
+// direction-optimizing breadth-first search (top-down steps while the frontier is small,
+// bottom-up steps while it is large)
+// in = the graph with its edges reversed (the graph itself if it is undirected)
+// dist is the number of edges from source, parent the vertex each one was reached from
+// G is any graph with size(), exists(), degree(), edgeCount() and a row(u) Cursor
+// (a CSR, the GraphCSR of a Graph, see TypedGraph.h, or a CompressedCSR)
+template <class G>
+ShortestPaths bfs(const G& g, const G& in, size_t source)
+{
+	ShortestPaths sp;
+	sp.source = source;
+	sp.dist.assign(g.size(), UNREACHABLE);
+	sp.parent.assign(g.size(), NO_PARENT);
+
+	if (!g.exists(source))
+		return sp;
+
+	size_t n = g.size();
+	Bitmap visited(n), front_bits(n), next_bits(n);
+	std::vector<size_t> frontier, next;
+
+	sp.dist[source] = 0;
+	visited.set(source);
+	frontier.push_back(source);
+
+	size_t frontier_size = 1;
+	size_t frontier_edges = g.degree(source);
+	size_t unexplored_edges = g.edgeCount() - frontier_edges;
+	bool bottom_up = false;
+
+	for (size_t level = 1; frontier_size > 0; level++)
+	{
+		if (!bottom_up && frontier_edges > unexplored_edges / BFS_ALPHA)
+		{
+			front_bits.clear();
+			for (size_t u : frontier)
+				front_bits.set(u);
+			bottom_up = true;
+		}
+		else if (bottom_up && frontier_size < n / BFS_BETA)
+		{
+			frontier.clear();
+			for (size_t v = 0; v < n; v++)
+				if (front_bits.get(v))
+					frontier.push_back(v);
+			bottom_up = false;
+		}
+
+		if (bottom_up)
+		{
+			bfs_bottomUpStep(g, in, sp, visited, level, front_bits, next_bits, frontier_size, frontier_edges);
+			std::swap(front_bits, next_bits);
+		}
+		else
+		{
+			bfs_topDownStep(g, sp, visited, level, frontier, next, frontier_edges);
+			std::swap(frontier, next);
+			frontier_size = frontier.size();
+		}
+
+		unexplored_edges -= (frontier_edges < unexplored_edges) ? frontier_edges : unexplored_edges;
+	}
+
+	return sp;
+}
+
+// level-synchronous breadth-first search that expands each frontier on all threads of pool
+// a vertex belongs to whichever thread first swaps its parent from NO_PARENT with a compare-and-swap,
+// so every vertex is added to the next frontier exactly once (parents may differ from run to run, distances don't)
+inline ShortestPaths parallelBfs(const CSR& g, size_t source, ThreadPool& pool)
+{
+	ShortestPaths sp;
+	sp.source = source;
+	sp.dist.assign(g.size(), UNREACHABLE);
+	sp.parent.assign(g.size(), NO_PARENT);
+
+	if (!g.exists(source))
+		return sp;
+
+	// the source is its own parent while the search runs, so nobody claims it
+	sp.dist[source] = 0;
+	sp.parent[source] = source;
+
+	std::vector<size_t> frontier(1, source), next;
+
+	// vertices found by each thread in the current level
+	std::vector<std::vector<size_t>> found(pool.size());
+
+	for (size_t level = 1; !frontier.empty(); level++)
+	{
+		pool.parallelFor(0, frontier.size(), 64, [&](size_t lo, size_t hi, size_t thread_id)
+		{
+			std::vector<size_t>& mine = found[thread_id];
+			for (size_t i = lo; i < hi; i++)
+			{
+				size_t u = frontier[i];
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				{
+					size_t v = g.targets[e];
+
+					// cheap check first, most edges lead to vertices already claimed
+					std::atomic_ref<size_t> parent_v(sp.parent[v]);
+					if (parent_v.load(std::memory_order_relaxed) != NO_PARENT)
+						continue;
+
+					size_t expected = NO_PARENT;
+					if (parent_v.compare_exchange_strong(expected, u, std::memory_order_relaxed))
+					{
+						sp.dist[v] = level;
+						mine.push_back(v);
+					}
+				}
+			}
+		});
+
+		// concatenate what the threads found into the next frontier, each thread copying its own part
+		std::vector<size_t> start(found.size() + 1, 0);
+		for (size_t t = 0; t < found.size(); t++)
+			start[t + 1] = start[t] + found[t].size();
+
+		next.resize(start.back());
+		pool.runOnAll([&](size_t thread_id)
+		{
+			std::copy(found[thread_id].begin(), found[thread_id].end(), next.begin() + start[thread_id]);
+			found[thread_id].clear();
+		});
+		std::swap(frontier, next);
+	}
+
+	sp.parent[source] = NO_PARENT;
+	return sp;
+}
+
+#endif
@@ -0,0 +1,264 @@
+#ifndef CSR_H
+#define CSR_H
+
+#include "List.h"
+#include <memory>
+#include <vector>
+
+// compressed sparse row (CSR) snapshot of an adjacency list
+// neighbours of vertex u are targets[offsets[u]] ... targets[offsets[u + 1] - 1],
+// and weights[e] is the weight of the edge stored at targets[e]
+// the arrays are read through plain pointers, which point either into the vectors the CSR owns
+// or into memory it was handed with view() (e.g. a memory-mapped file, see CSRFile.h)
+class CSR
+{
+public:
+	// offsets has one entry per vertex index plus one, so row u is [offsets[u], offsets[u + 1])
+	const size_t* offsets;
+
+	// vertex index at the other end of each edge
+	const size_t* targets;
+
+	// weight of each edge (parallel to targets)
+	const size_t* weights;
+
+	// present[u] is 0 for indices whose vertex was removed (they have an empty row)
+	const unsigned char* present;
+
+	// number of vertex indices and of stored edges
+	size_t vertex_count;
+	size_t edge_count;
+
+	// arrays owned by this CSR, the pointers above point into these unless the CSR views outside memory
+	std::vector<size_t> offset_store;
+	std::vector<size_t> target_store;
+	std::vector<size_t> weight_store;
+	std::vector<unsigned char> present_store;
+
+	// keeps the outside memory alive while this CSR (or a copy of it) views it
+	std::shared_ptr<const void> backing;
+
+	CSR()
+	{
+		offset_store.push_back(0);
+		vertex_count = 0;
+		edge_count = 0;
+		viewStores();
+	}
+
+	CSR(const CSR& other)
+	{
+		*this = other;
+	}
+
+	CSR(CSR&& other)
+	{
+		*this = std::move(other);
+	}
+
+	CSR& operator=(const CSR& other)
+	{
+		if (this == &other)
+			return *this;
+
+		offset_store = other.offset_store;
+		target_store = other.target_store;
+		weight_store = other.weight_store;
+		present_store = other.present_store;
+		adopt(other);
+		return *this;
+	}
+
+	CSR& operator=(CSR&& other)
+	{
+		if (this == &other)
+			return *this;
+
+		offset_store = std::move(other.offset_store);
+		target_store = std::move(other.target_store);
+		weight_store = std::move(other.weight_store);
+		present_store = std::move(other.present_store);
+		adopt(other);
+		return *this;
+	}
+
+	// points the arrays at outside memory, which keep_alive keeps valid (the CSR's own vectors are freed)
+	void view(size_t n, size_t m, const size_t* _offsets, const size_t* _targets, const size_t* _weights,
+		const unsigned char* _present, std::shared_ptr<const void> keep_alive)
+	{
+		offset_store = std::vector<size_t>();
+		target_store = std::vector<size_t>();
+		weight_store = std::vector<size_t>();
+		present_store = std::vector<unsigned char>();
+
+		vertex_count = n;
+		edge_count = m;
+		offsets = _offsets;
+		targets = _targets;
+		weights = _weights;
+		present = _present;
+		backing = std::move(keep_alive);
+	}
+
+	// rebuilds the arrays from a chain of lists
+	// n = number of vertex indices handed out so far (AdjList::list_counter)
+	void build(List* first_list, size_t n)
+	{
+		backing.reset();
+		offset_store.assign(n + 1, 0);
+		present_store.assign(n, 0);
+
+		// first pass: count the degree of every vertex
+		for (List* listptr = first_list; listptr != nullptr; listptr = listptr->next)
+		{
+			offset_store[listptr->list_index + 1] = listptr->list_size;
+			present_store[listptr->list_index] = 1;
+		}
+
+		// prefix sum turns degrees into row offsets
+		for (size_t i = 0; i < n; i++)
+			offset_store[i + 1] += offset_store[i];
+
+		target_store.resize(offset_store[n]);
+		weight_store.resize(offset_store[n]);
+
+		// second pass: copy the neighbours, keeping the order of each list
+		for (List* listptr = first_list; listptr != nullptr; listptr = listptr->next)
+		{
+			size_t e = offset_store[listptr->list_index];
+			for (ListNode* ptr = listptr->head; ptr != nullptr; ptr = ptr->next, e++)
+			{
+				target_store[e] = ptr->index;
+				weight_store[e] = ptr->weight;
+			}
+		}
+
+		vertex_count = n;
+		edge_count = offset_store[n];
+		viewStores();
+	}
+
+	// takes over arrays built elsewhere (e.g. from a Graph, see TypedGraph.h), _offsets has one entry per vertex plus one
+	void assign(std::vector<size_t> _offsets, std::vector<size_t> _targets, std::vector<size_t> _weights,
+		std::vector<unsigned char> _present)
+	{
+		backing.reset();
+		offset_store = std::move(_offsets);
+		target_store = std::move(_targets);
+		weight_store = std::move(_weights);
+		present_store = std::move(_present);
+
+		vertex_count = present_store.size();
+		edge_count = target_store.size();
+		viewStores();
+	}
+
+	// returns the same graph with every edge reversed, so row u lists the vertices that have an edge to u
+	CSR reversed() const
+	{
+		CSR r;
+		size_t n = size();
+		r.present_store.assign(present, present + n);
+		r.offset_store.assign(n + 1, 0);
+		r.target_store.resize(edge_count);
+		r.weight_store.resize(edge_count);
+
+		for (size_t e = 0; e < edge_count; e++)
+			r.offset_store[targets[e] + 1]++;
+		for (size_t i = 0; i < n; i++)
+			r.offset_store[i + 1] += r.offset_store[i];
+
+		// next free position in every row of r
+		std::vector<size_t> fill(r.offset_store.begin(), r.offset_store.end() - 1);
+		for (size_t u = 0; u < n; u++)
+			for (size_t e = offsets[u]; e < offsets[u + 1]; e++)
+			{
+				size_t pos = fill[targets[e]]++;
+				r.target_store[pos] = u;
+				r.weight_store[pos] = weights[e];
+			}
+
+		r.vertex_count = n;
+		r.edge_count = edge_count;
+		r.viewStores();
+		return r;
+	}
+
+	// number of vertex indices (including removed ones)
+	size_t size() const { return vertex_count; }
+
+	// number of stored edges (an undirected edge is stored twice)
+	size_t edgeCount() const { return edge_count; }
+
+	// returns whether a vertex with this index exists
+	bool exists(size_t u) const { return u < size() && present[u]; }
+
+	// first and one-past-last edge positions of vertex u
+	size_t edgeBegin(size_t u) const { return offsets[u]; }
+	size_t edgeEnd(size_t u) const { return offsets[u + 1]; }
+
+	size_t degree(size_t u) const { return offsets[u + 1] - offsets[u]; }
+
+	// reads the row of one vertex, an edge at a time
+	// every graph the traversals run on has one (CSR, GraphCSR, CompressedCSR), so BasicDFS and bfs() only use this
+	class Cursor
+	{
+	public:
+		const size_t* targets;
+		const size_t* weights;
+
+		// position of the next edge to read, and the end of the row
+		size_t edge;
+		size_t end;
+
+		// other end of the edge last read by next() (the row's own vertex before the first call)
+		size_t vertex;
+
+		// reads the next edge, returns false once the row is done
+		bool next()
+		{
+			if (edge == end)
+				return false;
+			vertex = targets[edge++];
+			return true;
+		}
+
+		// weight of the edge last read by next()
+		size_t weight() const { return weights[edge - 1]; }
+	};
+
+	// returns a cursor at the start of the row of u
+	Cursor row(size_t u) const
+	{
+		return Cursor{targets, weights, offsets[u], offsets[u + 1], u};
+	}
+
+private:
+	// points the arrays at the CSR's own vectors
+	void viewStores()
+	{
+		offsets = offset_store.data();
+		targets = target_store.data();
+		weights = weight_store.data();
+		present = present_store.data();
+	}
+
+	// takes over the sizes and outside memory of other, once its vectors have been copied or moved here
+	void adopt(const CSR& other)
+	{
+		vertex_count = other.vertex_count;
+		edge_count = other.edge_count;
+		backing = other.backing;
+		if (backing)
+		{
+			offsets = other.offsets;
+			targets = other.targets;
+			weights = other.weights;
+			present = other.present;
+		}
+		else
+			viewStores();
+	}
+};
+
+#endif
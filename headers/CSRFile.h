@@ -0,0 +1,269 @@
+#ifndef CSR_FILE_H
+#define CSR_FILE_H
+
+#include "CSR.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the file arrays are mapped straight onto the size_t arrays of a CSR
+static_assert(sizeof(size_t) == sizeof(uint64_t), "CSR files need a 64-bit size_t");
+
+// binary CSR file: this header, then offsets[vertices + 1], targets[stored_edges], weights[stored_edges]
+// (uint64_t each, in the byte order of the machine that wrote it), then present[vertices] (one byte each)
+// everything before present is a multiple of 8 bytes long, so a mapping of the file can be used as is
+struct CSRFileHeader
+{
+	char magic[8];
+
+	// CSR_FILE_BYTE_ORDER as written, a file from a machine with the other byte order doesn't match it
+	uint64_t byte_order;
+
+	uint64_t version;
+	uint64_t vertices;
+	uint64_t stored_edges;
+
+	// edges of the graph (an undirected edge is stored twice, but counted once)
+	uint64_t edges;
+
+	uint64_t directed;
+	uint64_t weighted;
+};
+
+// outcome of opening a CSR file
+// CSR_FILE_UNREADABLE = the file can't be opened or mapped
+// CSR_FILE_NOT_CSR    = it isn't a CSR file this machine can read (magic, byte order or version differ)
+// CSR_FILE_CORRUPT    = the header or arrays don't describe a graph (e.g. a truncated file or an edge out of range)
+enum CSRFileStatus {CSR_FILE_OK, CSR_FILE_UNREADABLE, CSR_FILE_NOT_CSR, CSR_FILE_CORRUPT};
+
+inline const char* csrFileStatusMessage(CSRFileStatus status)
+{
+	switch (status)
+	{
+	case CSR_FILE_OK:
+		return "ok";
+	case CSR_FILE_UNREADABLE:
+		return "the file can't be opened";
+	case CSR_FILE_NOT_CSR:
+		return "not a CSR file this machine can read";
+	case CSR_FILE_CORRUPT:
+		return "the file is corrupt";
+	}
+	return "unknown status";
+}
+
+const char CSR_FILE_MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+const uint64_t CSR_FILE_BYTE_ORDER = 0x0102030405060708ULL;
+const uint64_t CSR_FILE_VERSION = 1;
+
+// writes g to path with the given header fields (magic, byte order, version and sizes are filled in)
+// returns false if the file couldn't be written
+inline bool writeCSRFile(const std::string& path, const CSR& g, CSRFileHeader header)
+{
+	memcpy(header.magic, CSR_FILE_MAGIC, sizeof(header.magic));
+	header.byte_order = CSR_FILE_BYTE_ORDER;
+	header.version = CSR_FILE_VERSION;
+	header.vertices = g.size();
+	header.stored_edges = g.edgeCount();
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+
+	// a graph without edges (or vertices) may have no target, weight or present arrays at all, fwrite() can't take those
+	size_t n = g.size(), m = g.edgeCount();
+	bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(g.offsets, sizeof(size_t), n + 1, file) == n + 1
+		&& (m == 0 || fwrite(g.targets, sizeof(size_t), m, file) == m)
+		&& (m == 0 || fwrite(g.weights, sizeof(size_t), m, file) == m)
+		&& (n == 0 || fwrite(g.present, 1, n, file) == n);
+
+	return (fclose(file) == 0) && ok;
+}
+
+// a read-only mapping of a whole file, unmapped when the last CSR viewing it goes away
+// (on Windows the file is read into memory instead)
+class MappedFile
+{
+public:
+	const unsigned char* data;
+	size_t length;
+
+#ifdef _WIN32
+	std::vector<uint64_t> buffer;
+#endif
+
+	MappedFile()
+	{
+		data = nullptr;
+		length = 0;
+	}
+
+	~MappedFile()
+	{
+#ifndef _WIN32
+		if (data != nullptr)
+			munmap((void*)data, length);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// returns false if the file can't be opened or mapped
+	// an empty file opens with data = nullptr and length = 0 (there is nothing to map)
+	bool open(const std::string& path)
+	{
+#ifndef _WIN32
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		if (info.st_size == 0)
+		{
+			close(fd);
+			return true;
+		}
+
+		// a shared read-only mapping, every process mapping the file reads the same page cache
+		void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (mapped == MAP_FAILED)
+			return false;
+
+		data = (const unsigned char*)mapped;
+		length = info.st_size;
+		return true;
+#else
+		FILE* file = fopen(path.c_str(), "rb");
+		if (file == nullptr)
+			return false;
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+		if (size <= 0)
+		{
+			fclose(file);
+			return size == 0;
+		}
+
+		buffer.resize((size + 7) / 8);
+		bool ok = fread(buffer.data(), 1, size, file) == (size_t)size;
+		fclose(file);
+
+		data = (const unsigned char*)buffer.data();
+		length = size;
+		return ok;
+#endif
+	}
+};
+
+// returns whether the arrays of a CSR file describe a graph an AdjList could have written, in O(vertices + edges):
+// offsets never go down, every row is inside targets, removed vertices have empty rows, every edge leads to
+// another vertex that exists, and in an undirected graph every edge (u, v) has its own (v, u)
+inline bool csrFile_valid(uint64_t n, uint64_t m, const size_t* offsets, const size_t* targets,
+	const unsigned char* present, bool directed)
+{
+	if (offsets[0] != 0 || offsets[n] != m)
+		return false;
+
+	for (size_t u = 0; u < n; u++)
+	{
+		if (offsets[u + 1] < offsets[u] || present[u] > 1 || (!present[u] && offsets[u + 1] != offsets[u]))
+			return false;
+
+		for (size_t e = offsets[u]; e < offsets[u + 1]; e++)
+			if (targets[e] >= n || targets[e] == u || !present[targets[e]])
+				return false;
+	}
+	if (directed)
+		return true;
+
+	// the sources of the edges into every vertex, in increasing order (a counting sort by target)
+	std::vector<size_t> in_offsets(n + 1, 0), sources(m);
+	for (size_t e = 0; e < m; e++)
+		in_offsets[targets[e] + 1]++;
+	for (size_t u = 0; u < n; u++)
+		in_offsets[u + 1] += in_offsets[u];
+	std::vector<size_t> fill(in_offsets.begin(), in_offsets.end() - 1);
+	for (size_t u = 0; u < n; u++)
+		for (size_t e = offsets[u]; e < offsets[u + 1]; e++)
+			sources[fill[targets[e]]++] = u;
+
+	// row u and the sources into u have to be the same multiset, counted up for one and down for the other
+	std::vector<size_t> count(n, 0);
+	for (size_t u = 0; u < n; u++)
+	{
+		if (in_offsets[u + 1] - in_offsets[u] != offsets[u + 1] - offsets[u])
+			return false;
+		for (size_t e = offsets[u]; e < offsets[u + 1]; e++)
+			count[targets[e]]++;
+		for (size_t e = in_offsets[u]; e < in_offsets[u + 1]; e++)
+			if (count[sources[e]]-- == 0)
+				return false;
+	}
+	return true;
+}
+
+// maps the CSR file at path and points g at it, without copying anything
+// header receives the file's header
+// the header and the file's length are always checked, and unless trusted is set every array is checked too
+// (see csrFile_valid(), reading the whole file and, for an undirected graph, taking O(edges) more memory),
+// so the algorithms can trust g like a CSR built in memory
+// trusted = true opens the file in O(1), for files known to come from saveBinary() or writeCSRFile()
+// (a damaged or hand-made file opened this way can make the algorithms read out of bounds)
+inline CSRFileStatus mapCSRFile(const std::string& path, CSR& g, CSRFileHeader& header, bool trusted = false)
+{
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+	if (!file->open(path))
+		return CSR_FILE_UNREADABLE;
+	if (file->length < sizeof(CSRFileHeader))
+		return CSR_FILE_NOT_CSR;
+
+	memcpy(&header, file->data, sizeof(header));
+	if (memcmp(header.magic, CSR_FILE_MAGIC, sizeof(header.magic)) != 0
+		|| header.byte_order != CSR_FILE_BYTE_ORDER || header.version != CSR_FILE_VERSION)
+		return CSR_FILE_NOT_CSR;
+
+	// the sizes have to add up to the file's length exactly (checked without overflowing on a corrupt header)
+	uint64_t n = header.vertices, m = header.stored_edges;
+	uint64_t words = (file->length - sizeof(header)) / 8;
+	if (n >= words || m > words || 2 * m > words - (n + 1)
+		|| sizeof(header) + 8 * (n + 1 + 2 * m) + n != file->length)
+		return CSR_FILE_CORRUPT;
+
+	// an undirected edge is stored once in each direction
+	if (header.directed > 1 || header.weighted > 1 || (header.directed ? header.edges : 2 * header.edges) != m)
+		return CSR_FILE_CORRUPT;
+
+	const size_t* arrays = (const size_t*)(file->data + sizeof(header));
+	const size_t* offsets = arrays;
+	const size_t* targets = offsets + n + 1;
+	const size_t* weights = targets + m;
+	const unsigned char* present = (const unsigned char*)(weights + m);
+
+	if (!trusted && !csrFile_valid(n, m, offsets, targets, present, header.directed != 0))
+		return CSR_FILE_CORRUPT;
+
+	g.view(n, m, offsets, targets, weights, present, file);
+	return CSR_FILE_OK;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "CSR.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+// component id of removed vertices
+const size_t NO_COMPONENT = SIZE_MAX;
+
+// connected components of a graph (weakly connected components if it is directed)
+// id[v] is the component of vertex v, numbered 0 .. count() - 1 in order of their lowest vertex,
+// and sizes[c] is the number of vertices in component c
+struct Components
+{
+	std::vector<size_t> id;
+	std::vector<size_t> sizes;
+
+	size_t count() const { return sizes.size(); }
+};
+
+// numbers the components given any representative vertex per component (label[v] = representative of v)
+inline Components components_fromLabels(const CSR& g, const std::vector<size_t>& label)
+{
+	Components cc;
+	cc.id.assign(g.size(), NO_COMPONENT);
+
+	// component id given to each representative, found while scanning the vertices in order
+	std::vector<size_t> numbered(g.size(), NO_COMPONENT);
+
+	for (size_t v = 0; v < g.size(); v++)
+	{
+		if (!g.exists(v))
+			continue;
+
+		size_t& c = numbered[label[v]];
+		if (c == NO_COMPONENT)
+		{
+			c = cc.sizes.size();
+			cc.sizes.push_back(0);
+		}
+		cc.id[v] = c;
+		cc.sizes[c]++;
+	}
+
+	return cc;
+}
+
+// connected components with a union-find over the edges, O(E α(V))
+inline Components connectedComponents(const CSR& g)
+{
+	UnionFind sets(g.size());
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			sets.unite(u, g.targets[e]);
+
+	std::vector<size_t> label(g.size());
+	for (size_t v = 0; v < g.size(); v++)
+		label[v] = sets.find(v);
+
+	return components_fromLabels(g, label);
+}
+
+// connected components on the threads of pool, Shiloach-Vishkin style:
+// every round hooks the root of the larger label under the smaller label across each edge,
+// then shortens every label chain to point straight at its root (pointer jumping),
+// until a round hooks nothing
+// labels only ever decrease, so the hooks of different threads racing on one root can't form a cycle
+inline Components parallelConnectedComponents(const CSR& g, ThreadPool& pool)
+{
+	size_t n = g.size();
+	std::vector<size_t> label(n);
+	for (size_t v = 0; v < n; v++)
+		label[v] = v;
+
+	auto at = [&](size_t v) { return std::atomic_ref<size_t>(label[v]); };
+
+	std::atomic<bool> hooked(true);
+	while (hooked.load(std::memory_order_relaxed))
+	{
+		hooked.store(false, std::memory_order_relaxed);
+
+		pool.parallelFor(0, n, 1024, [&](size_t lo, size_t hi, size_t)
+		{
+			bool mine = false;
+			for (size_t u = lo; u < hi; u++)
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				{
+					size_t lu = at(u).load(std::memory_order_relaxed);
+					size_t lv = at(g.targets[e]).load(std::memory_order_relaxed);
+					if (lu == lv)
+						continue;
+
+					size_t high = (lu > lv) ? lu : lv;
+					size_t low = (lu > lv) ? lv : lu;
+
+					// only a root (label[high] == high) is hooked, if it isn't one any more the next round retries
+					size_t expected = high;
+					if (at(high).compare_exchange_strong(expected, low, std::memory_order_relaxed))
+						mine = true;
+				}
+			if (mine)
+				hooked.store(true, std::memory_order_relaxed);
+		});
+
+		pool.parallelFor(0, n, 4096, [&](size_t lo, size_t hi, size_t)
+		{
+			for (size_t v = lo; v < hi; v++)
+			{
+				size_t l = at(v).load(std::memory_order_relaxed);
+				size_t ll = at(l).load(std::memory_order_relaxed);
+				while (l != ll)
+				{
+					l = ll;
+					ll = at(l).load(std::memory_order_relaxed);
+				}
+				at(v).store(l, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	return components_fromLabels(g, label);
+}
+
+#endif
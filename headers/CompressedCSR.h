@@ -0,0 +1,222 @@
+#ifndef COMPRESSED_CSR_H
+#define COMPRESSED_CSR_H
+
+#include "CSR.h"
+#include "DFS.h"
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// writes value as a varint: 7 bits per byte, lowest first, the top bit set on every byte but the last
+inline void compressed_writeVarint(std::vector<unsigned char>& bytes, size_t value)
+{
+	while (value >= 0x80)
+	{
+		bytes.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	bytes.push_back((unsigned char)value);
+}
+
+// reads a varint at p and moves p past it
+inline size_t compressed_readVarint(const unsigned char*& p)
+{
+	// most deltas of a well-ordered graph fit in one byte
+	size_t byte = *p++;
+	if (byte < 0x80)
+		return byte;
+
+	size_t value = byte & 0x7f;
+	for (unsigned shift = 7; ; shift += 7)
+	{
+		byte = *p++;
+		value |= (byte & 0x7f) << shift;
+		if (byte < 0x80)
+			return value;
+	}
+}
+
+// vertices of a CompressedCSR whose row offsets are counted from the same 64-bit base
+const size_t COMPRESSED_BLOCK = 64;
+
+// read-only CSR with every neighbour list sorted and compressed (in the style of WebGraph and Ligra+)
+// the row of u is its degree, then its first neighbour as a zig-zag coded difference from u,
+// then every other neighbour as its difference from the one before (each a varint,
+// followed by the edge's weight as a varint if the CSR keeps weights)
+// vertices numbered for locality (see Reorder.h) have small differences, mostly one byte each
+// rows are read with a Cursor like those of CSR, so bfs() and BasicDFS (CompressedDFS) run on it unchanged
+class CompressedCSR
+{
+public:
+	// row u starts at bytes[block_offsets[u / COMPRESSED_BLOCK] + offsets[u]], so a vertex takes a 4-byte offset
+	// (and a share of its block's 8-byte one) instead of an 8-byte one
+	std::vector<size_t> block_offsets;
+	std::vector<uint32_t> offsets;
+
+	// only for a graph with over 4 GiB of rows in one block: offsets is left empty and row u starts at wide_offsets[u]
+	std::vector<size_t> wide_offsets;
+
+	std::vector<unsigned char> bytes;
+
+	// present[u] is 0 for indices whose vertex was removed (they have an empty row)
+	std::vector<unsigned char> present;
+
+	size_t edge_count;
+
+	// whether the rows keep edge weights (every weight is 1 otherwise)
+	bool weighted;
+
+	// decodes one row, a neighbour at a time (see CSR::Cursor)
+	class Cursor
+	{
+	public:
+		const unsigned char* pos;
+		size_t remaining;
+		size_t degree;
+
+		// neighbour and weight of the edge last read by next() (vertex starts as the row's own vertex)
+		size_t vertex;
+		size_t edge_weight;
+
+		bool weighted;
+
+		// reads the next edge, returns false once the row is done
+		bool next()
+		{
+			if (remaining == 0)
+				return false;
+
+			size_t delta = compressed_readVarint(pos);
+			if (remaining == degree)
+				vertex += (delta >> 1) ^ (0 - (delta & 1));
+			else
+				vertex += delta;
+			if (weighted)
+				edge_weight = compressed_readVarint(pos);
+
+			remaining--;
+			return true;
+		}
+
+		size_t weight() const { return edge_weight; }
+	};
+
+	CompressedCSR()
+	{
+		edge_count = 0;
+		weighted = false;
+	}
+
+	// compresses g, keeping its weights if keep_weights is set
+	CompressedCSR(const CSR& g, bool keep_weights)
+	{
+		build(g, keep_weights);
+	}
+
+	void build(const CSR& g, bool keep_weights)
+	{
+		size_t n = g.size();
+		weighted = keep_weights;
+		edge_count = g.edgeCount();
+		present.assign(g.present, g.present + n);
+		block_offsets.assign((n + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK, 0);
+		offsets.assign(n, 0);
+		wide_offsets.clear();
+		bytes.clear();
+		bytes.reserve(edge_count * (weighted ? 3 : 2) + n);
+
+		std::vector<std::pair<size_t, size_t>> row;
+		for (size_t u = 0; u < n; u++)
+		{
+			if (u % COMPRESSED_BLOCK == 0)
+				block_offsets[u / COMPRESSED_BLOCK] = bytes.size();
+			size_t offset = bytes.size() - block_offsets[u / COMPRESSED_BLOCK];
+			if (offset > UINT32_MAX && wide_offsets.empty())
+			{
+				wide_offsets.resize(n);
+				for (size_t w = 0; w < u; w++)
+					wide_offsets[w] = block_offsets[w / COMPRESSED_BLOCK] + offsets[w];
+			}
+			if (wide_offsets.empty())
+				offsets[u] = (uint32_t)offset;
+			else
+				wide_offsets[u] = bytes.size();
+
+			row.clear();
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				row.emplace_back(g.targets[e], g.weights[e]);
+			std::sort(row.begin(), row.end());
+
+			compressed_writeVarint(bytes, row.size());
+			size_t prev = u;
+			for (size_t i = 0; i < row.size(); i++)
+			{
+				size_t v = row[i].first;
+				if (i == 0)
+				{
+					// the first difference can be negative: 0, -1, 1, -2, 2, ... are coded as 0, 1, 2, 3, 4, ...
+					size_t delta = v - prev;
+					compressed_writeVarint(bytes, (v >= prev) ? 2 * delta : 2 * (prev - v) - 1);
+				}
+				else
+					compressed_writeVarint(bytes, v - prev);
+				if (weighted)
+					compressed_writeVarint(bytes, row[i].second);
+				prev = v;
+			}
+		}
+
+		if (!wide_offsets.empty())
+			offsets = std::vector<uint32_t>();
+		bytes.shrink_to_fit();
+	}
+
+	// returns where the row of u starts
+	const unsigned char* rowStart(size_t u) const
+	{
+		if (!wide_offsets.empty())
+			return bytes.data() + wide_offsets[u];
+		return bytes.data() + block_offsets[u / COMPRESSED_BLOCK] + offsets[u];
+	}
+
+	// number of vertex indices (including removed ones)
+	size_t size() const { return present.size(); }
+
+	// number of stored edges (an undirected edge is stored twice)
+	size_t edgeCount() const { return edge_count; }
+
+	// returns whether a vertex with this index exists
+	bool exists(size_t u) const { return u < size() && present[u]; }
+
+	size_t degree(size_t u) const
+	{
+		const unsigned char* p = rowStart(u);
+		return compressed_readVarint(p);
+	}
+
+	// returns a cursor at the start of the row of u
+	Cursor row(size_t u) const
+	{
+		Cursor c;
+		c.pos = rowStart(u);
+		c.degree = c.remaining = compressed_readVarint(c.pos);
+		c.vertex = u;
+		c.edge_weight = 1;
+		c.weighted = weighted;
+		return c;
+	}
+
+	// bytes taken by the compressed graph
+	size_t memoryUsed() const
+	{
+		return block_offsets.size() * sizeof(size_t) + offsets.size() * sizeof(uint32_t)
+			+ wide_offsets.size() * sizeof(size_t) + bytes.size() + present.size();
+	}
+};
+
+// iterative depth-first search over a CompressedCSR, every stack frame keeps the cursor of its vertex's row,
+// so each row is decoded once per visit
+typedef BasicDFS<CompressedCSR> CompressedDFS;
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef DFS_H
+#define DFS_H
+
+#include "CSR.h"
+#include <vector>
+
+enum Colour {WHITE, GRAY, BLACK};
+
+// what the pre-order hook of a DFS wants done with the vertex it was called for
+// DFS_CONTINUE = explore its edges, DFS_SKIP_CHILDREN = treat it as finished right away, DFS_STOP = end the search
+enum DFSAction {DFS_CONTINUE, DFS_SKIP_CHILDREN, DFS_STOP};
+
+// default hooks for DFS::run()
+struct DFSNoPreHook
+{
+	DFSAction operator()(size_t) const { return DFS_CONTINUE; }
+};
+
+struct DFSNoHook
+{
+	bool operator()(size_t) const { return false; }
+	bool operator()(size_t, size_t) const { return false; }
+};
+
+// iterative depth-first search over a CSR, using an explicit stack instead of recursion
+// colour[] and the stack are allocated once, when the DFS is made, and reused by every run()
+// G is any graph with size() and a row(u) Cursor (CSR, the GraphCSR of a Graph or a CompressedCSR)
+template <class G>
+class BasicDFS
+{
+public:
+	// a vertex on the stack, and the cursor at the next of its edges to look at
+	struct Frame
+	{
+		size_t vertex;
+		typename G::Cursor cursor;
+	};
+
+	const G& g;
+
+	// WHITE = not reached yet, GRAY = on the stack, BLACK = finished
+	std::vector<unsigned char> colour;
+
+	std::vector<Frame> stack;
+
+	BasicDFS(const G& _g) : g(_g), colour(_g.size(), WHITE)
+	{
+		stack.reserve(_g.size());
+	}
+
+	// marks every vertex WHITE again
+	void reset()
+	{
+		colour.assign(g.size(), WHITE);
+	}
+
+	// depth-first search from root over the vertices that are still WHITE
+	// pre(u)     called when u is reached (u is GRAY), returns a DFSAction
+	// post(u)    called when u is finished (u is BLACK, post may set it back to WHITE to allow reaching it again)
+	// back(u, v) called for every edge (u, v) to a GRAY vertex
+	// post and back return true to end the search
+	// returns true if a hook ended the search
+	template <class Pre, class Post, class Back>
+	bool run(size_t root, Pre&& pre, Post&& post, Back&& back)
+	{
+		stack.clear();
+
+		colour[root] = GRAY;
+		DFSAction action = pre(root);
+		if (action == DFS_STOP)
+			return true;
+		if (action == DFS_SKIP_CHILDREN)
+		{
+			colour[root] = BLACK;
+			return post(root);
+		}
+		stack.push_back(Frame{root, g.row(root)});
+
+		while (!stack.empty())
+		{
+			Frame& top = stack.back();
+			size_t u = top.vertex;
+
+			// all edges of u done
+			if (!top.cursor.next())
+			{
+				stack.pop_back();
+				colour[u] = BLACK;
+				if (post(u))
+					return true;
+				continue;
+			}
+
+			size_t v = top.cursor.vertex;
+			if (colour[v] == WHITE)
+			{
+				colour[v] = GRAY;
+				action = pre(v);
+				if (action == DFS_STOP)
+					return true;
+				if (action == DFS_SKIP_CHILDREN)
+				{
+					colour[v] = BLACK;
+					if (post(v))
+						return true;
+				}
+				else
+					stack.push_back(Frame{v, g.row(v)});
+			}
+			else if (colour[v] == GRAY && back(u, v))
+				return true;
+		}
+
+		return false;
+	}
+
+	template <class Pre>
+	bool run(size_t root, Pre&& pre)
+	{
+		return run(root, pre, DFSNoHook(), DFSNoHook());
+	}
+};
+
+typedef BasicDFS<CSR> DFS;
+
+#endif
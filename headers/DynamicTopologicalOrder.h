@@ -0,0 +1,217 @@
+#ifndef DYNAMIC_TOPOLOGICAL_ORDER_H
+#define DYNAMIC_TOPOLOGICAL_ORDER_H
+
+#include <algorithm>
+#include <vector>
+
+// topological order of a directed acyclic graph that is kept up to date as edges are added (Pearce-Kelly)
+// an edge (u, v) with u already before v costs nothing, otherwise only the vertices placed between v and u
+// are searched and reordered, and the edge is refused if v turns out to reach u (it would close a cycle)
+// keeps its own successor and predecessor lists, since the search has to go both ways
+class DynamicTopologicalOrder
+{
+public:
+	// position of every vertex in the order, and the vertex at every position
+	std::vector<size_t> position;
+	std::vector<size_t> vertex_at;
+
+	std::vector<std::vector<size_t>> successors;
+	std::vector<std::vector<size_t>> predecessors;
+
+	// vertices already searched in the current addEdge() call (mark[v] == pass), so they are never cleared
+	std::vector<size_t> mark;
+	size_t pass;
+
+	// vertices of the affected region found searching forwards from v and backwards from u
+	std::vector<size_t> delta_forward;
+	std::vector<size_t> delta_backward;
+	std::vector<size_t> stack;
+
+	DynamicTopologicalOrder()
+	{
+		pass = 0;
+	}
+
+	// forgets every vertex and edge
+	void clear()
+	{
+		position.clear();
+		vertex_at.clear();
+		successors.clear();
+		predecessors.clear();
+		mark.clear();
+		pass = 0;
+	}
+
+	// starts over with n vertices and no edges, placed in the given order (vertices missing from it go last)
+	void assign(size_t n, const std::vector<size_t>& order)
+	{
+		clear();
+		position.assign(n, n);
+		vertex_at.reserve(n);
+		for (size_t v : order)
+		{
+			position[v] = vertex_at.size();
+			vertex_at.push_back(v);
+		}
+		for (size_t v = 0; v < n; v++)
+			if (position[v] == n)
+			{
+				position[v] = vertex_at.size();
+				vertex_at.push_back(v);
+			}
+
+		successors.resize(n);
+		predecessors.resize(n);
+		mark.assign(n, 0);
+	}
+
+	// adds a vertex with the next index, placed after all others
+	size_t addVertex()
+	{
+		size_t v = position.size();
+		position.push_back(v);
+		vertex_at.push_back(v);
+		successors.emplace_back();
+		predecessors.emplace_back();
+		mark.push_back(0);
+		return v;
+	}
+
+	// adds edge (u -> v) and moves vertices around so that u still comes before v
+	// returns false without changing anything if v can already reach u
+	bool addEdge(size_t u, size_t v)
+	{
+		if (position[u] < position[v])
+		{
+			link(u, v);
+			return true;
+		}
+
+		// the affected region is everything from v's position up to u's
+		size_t lower = position[v], upper = position[u];
+		pass++;
+		if (!searchForward(v, u, upper))
+			return false;
+		searchBackward(u, lower);
+		reorder();
+
+		link(u, v);
+		return true;
+	}
+
+	// removes one edge (u -> v), the order stays valid without it
+	void removeEdge(size_t u, size_t v)
+	{
+		unlink(successors[u], v);
+		unlink(predecessors[v], u);
+	}
+
+	// removes every edge of v, it keeps its place in the order
+	void isolateVertex(size_t v)
+	{
+		for (size_t w : successors[v])
+			unlink(predecessors[w], v);
+		for (size_t w : predecessors[v])
+			unlink(successors[w], v);
+		successors[v].clear();
+		predecessors[v].clear();
+	}
+
+private:
+	void link(size_t u, size_t v)
+	{
+		successors[u].push_back(v);
+		predecessors[v].push_back(u);
+	}
+
+	static void unlink(std::vector<size_t>& list, size_t v)
+	{
+		std::vector<size_t>::iterator it = std::find(list.begin(), list.end(), v);
+		if (it != list.end())
+		{
+			*it = list.back();
+			list.pop_back();
+		}
+	}
+
+	// collects the vertices v reaches that are placed before u (at upper), returns false if it reaches u itself
+	bool searchForward(size_t v, size_t u, size_t upper)
+	{
+		delta_forward.clear();
+		stack.assign(1, v);
+		mark[v] = pass;
+
+		while (!stack.empty())
+		{
+			size_t w = stack.back();
+			stack.pop_back();
+			delta_forward.push_back(w);
+
+			for (size_t x : successors[w])
+			{
+				if (x == u)
+					return false;
+				if (mark[x] != pass && position[x] < upper)
+				{
+					mark[x] = pass;
+					stack.push_back(x);
+				}
+			}
+		}
+		return true;
+	}
+
+	// collects the vertices that reach u and are placed after v (at lower)
+	void searchBackward(size_t u, size_t lower)
+	{
+		delta_backward.clear();
+		stack.assign(1, u);
+		mark[u] = pass;
+
+		while (!stack.empty())
+		{
+			size_t w = stack.back();
+			stack.pop_back();
+			delta_backward.push_back(w);
+
+			for (size_t x : predecessors[w])
+				if (mark[x] != pass && position[x] > lower)
+				{
+					mark[x] = pass;
+					stack.push_back(x);
+				}
+		}
+	}
+
+	// hands the positions the two sets take up back to them, the backward set first,
+	// each set keeping its own relative order
+	void reorder()
+	{
+		auto earlier = [this](size_t a, size_t b) { return position[a] < position[b]; };
+		std::sort(delta_backward.begin(), delta_backward.end(), earlier);
+		std::sort(delta_forward.begin(), delta_forward.end(), earlier);
+
+		std::vector<size_t> slots;
+		slots.reserve(delta_backward.size() + delta_forward.size());
+		for (size_t w : delta_backward)
+			slots.push_back(position[w]);
+		for (size_t w : delta_forward)
+			slots.push_back(position[w]);
+		std::sort(slots.begin(), slots.end());
+
+		size_t i = 0;
+		for (size_t w : delta_backward)
+		{
+			position[w] = slots[i];
+			vertex_at[slots[i++]] = w;
+		}
+		for (size_t w : delta_forward)
+		{
+			position[w] = slots[i];
+			vertex_at[slots[i++]] = w;
+		}
+	}
+};
+
+#endif
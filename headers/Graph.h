@@ -2,29 +2,72 @@
 #define GRAPH_H
 
 #include "List.h"
+#include "CSR.h"
+#include "CSRFile.h"
+#include "CompressedCSR.h"
+#include "Import.h"
+#include "ShortestPaths.h"
+#include "DFS.h"
+#include "BFS.h"
+#include "MST.h"
+#include "Components.h"
+#include "SCC.h"
+#include "TopologicalSort.h"
+#include "DynamicTopologicalOrder.h"
+#include "Paths.h"
+#include "Reorder.h"
+#include "UnionFind.h"
 #include <iostream>
 #include <vector>
 #include <queue>
-#include <stack>
+#include <span>
+#include <tuple>
+#include <string>
+#include <functional>
+#include <algorithm>
 #include <limits.h>
 
 #define INF INT_MAX
 
 using namespace std;
 
-enum Colour {WHITE, GRAY, BLACK};
+// outcome of an operation that modifies the graph
+// (GRAPH_DIRECTED and GRAPH_DISCONNECTED are returned by algorithms that need an undirected or connected graph,
+// GRAPH_CYCLE by anything that needs a directed graph without cycles, GRAPH_FILE_ERROR when a file can't be used,
+// GRAPH_DUPLICATE_EDGE by addEdge() for an edge the graph already has, while it doesn't allow parallel edges)
+enum GraphStatus {GRAPH_OK, GRAPH_NO_SUCH_VERTEX, GRAPH_NO_SUCH_EDGE, GRAPH_SELF_LOOP, GRAPH_DIRECTED, GRAPH_DISCONNECTED, GRAPH_CYCLE,
+	GRAPH_FILE_ERROR, GRAPH_DUPLICATE_EDGE};
+
+// receives the log messages of an AdjList (see AdjList::log_sink)
+typedef function<void(const string&)> LogSink;
+
+const char* statusMessage(GraphStatus status);
 
 bool printPath_util(size_t idx, size_t j, int** paths, size_t start, size_t end);
 void printPath(size_t idx, int** paths, size_t dist[], size_t n);
+void printPath(const ShortestPaths& sp);
 void printShortestPath_fixedNode(size_t idx, int** paths, size_t** dist, size_t n);
 void printShortestPath(int** paths, size_t** dist, size_t n, bool fixedSource);
-size_t minKey(std::vector<size_t> key, vector<bool> included_vertices, size_t V);
+void printShortestPath(AllPairsPaths& ap, bool fixedSource);
+void printComponents(const Components& cc);
 
 class AdjList{
 public:
 
+	// every ListNode and List of the graph is allocated from these pools
+	// and freed all at once when the graph is destroyed
+	Pool<ListNode> node_pool;
+	Pool<List> list_pool;
+
 	List* first_list;
 
+	// last list in the chain, so addList() can append without walking the chain
+	List* last_list;
+
+	// direct lookup from vertex index to its list
+	// (list_table[i] is nullptr if vertex i has been removed)
+	vector<List*> list_table;
+
 	// just a counter to know what index number to give newly made vertices
 	size_t list_counter;
 	
@@ -41,121 +84,429 @@ public:
 	// whether weighted graph or not
 	bool weighted;
 
+	// whether addEdge() may add an edge the graph already has (a parallel edge)
+	bool allow_parallel_edges;
+
+	// where messages about graph modifications go, logging is off while this is empty
+	LogSink log_sink;
+
+	// contiguous copy of the lists that the traversals run against
+	// rebuilt lazily by getCSR() after the graph has been modified
+	CSR csr;
+	bool csr_valid;
+
+	// csr with every edge reversed (only built for directed graphs), rebuilt lazily by getReverseCSR()
+	CSR reverse_csr;
+	bool reverse_csr_valid;
+
+	// vertices that are connected through edges added so far, one element per vertex index
+	// (removed vertices stay behind as sets of their own)
+	// addList() and addEdge() keep it up to date, removing an edge or vertex can split a set,
+	// so those only mark it stale and the next query rebuilds it from the CSR
+	UnionFind connectivity;
+	bool connectivity_valid;
+
+	// topological order kept up to date on every change while keep_topological_order is on
+	// (see keepTopologicalOrder(), addEdge() then refuses edges that would close a cycle)
+	DynamicTopologicalOrder topological_order;
+	bool keep_topological_order;
+
+	// in_edges[v] has the vertex every edge into v comes from (once per edge), kept while keep_in_edges is on
+	// (see keepInEdges(), only directed graphs need it: an undirected edge is in the lists of both its ends)
+	vector<vector<size_t>> in_edges;
+	bool keep_in_edges;
+
 	// number = size_t (number of lists to initialise with)
 	// directed = boolean (whether graph is directed or not)
 	// weighted = boolean (whether it is weighted or not)
 	AdjList(size_t number, bool _directed, bool _weighted) // CONSTRUCTOR
 	{
 		first_list = nullptr;
+		last_list = nullptr;
 		list_counter = 0;
 		vertices = 0;
 		edges = 0;
 
 		directed = _directed;
 		weighted = _weighted;
+		allow_parallel_edges = true;
+
+		csr_valid = false;
+		reverse_csr_valid = false;
+		connectivity_valid = true;
+		keep_topological_order = false;
+		keep_in_edges = false;
 
 		for (size_t i = 0; i < number; i++)
 			addList();
 	}
 
+	// DESTRUCTOR, lists are destroyed for their node indices, nodes don't own anything so releasing the pools
+	// frees the rest of the graph
+	~AdjList()
+	{
+		for (List* listptr = first_list; listptr != nullptr; )
+		{
+			List* temp = listptr;
+			listptr = listptr->next;
+			list_pool.destroy(temp);
+		}
+		node_pool.release();
+		list_pool.release();
+	}
+
+	AdjList(const AdjList&) = delete;
+	AdjList& operator=(const AdjList&) = delete;
+
 	// inserts list (adds vertex) into adjacency list
 	bool addList()
 	{
+		csr_valid = false;
+
+		List* listptr = list_pool.create(list_counter, &node_pool);
+
 		if (first_list == nullptr)
+			first_list = listptr;
+		else
 		{
-			// cout << "Added list with index %d\n", adjlist->list_counter);
-			first_list = new List(list_counter);
-			vertices++;
-			list_counter++;
-			return true;
+			last_list->next = listptr;
+			listptr->prev = last_list;
 		}
 
-		List* listptr = first_list;
-
-		while (listptr->next != nullptr)
-			listptr = listptr->next;
-
-		// cout << "Added list with index %d\n", adjlist->list_counter);
-		listptr->next = new List(list_counter);
+		last_list = listptr;
+		list_table.push_back(listptr);
+		connectivity.add();
+		if (keep_topological_order)
+			topological_order.addVertex();
+		if (keep_in_edges)
+			in_edges.emplace_back();
 		
 		list_counter++;
 		vertices++;
 		return true;
 	}
 
-	/// search for list with passed index, so we can find adjacent nodes
-	List* findListWithIndex (size_t index)
+	// saves the graph as a binary CSR file (see CSRFile.h), which fromBinary() or mapCSRFile() can open again
+	GraphStatus saveBinary(const string& path)
 	{
-		List* listptr = first_list;
-		while (listptr && listptr->list_index != index)
-			listptr = listptr->next;
-		if (listptr == nullptr)
+		CSRFileHeader header;
+		header.edges = edges;
+		header.directed = directed;
+		header.weighted = weighted;
+
+		if (!writeCSRFile(path, getCSR(), header))
 		{
-			cout << "This shouldn't happen!\n\n";
+			if (log_sink)
+				log("Couldn't write " + path);
+			return GRAPH_FILE_ERROR;
+		}
+		return GRAPH_OK;
+	}
+
+	// makes a graph from a binary CSR file written by saveBinary(), nullptr if the file can't be used
+	// (status, if given, receives the reason, see mapCSRFile())
+	// the file is memory-mapped and serves as the graph's CSR until the graph is first modified,
+	// but the lists are still rebuilt from it, so loading takes O(vertices + edges) like parsing would,
+	// only with less work per edge (for read-only use, mapCSRFile() gives the CSR without building any lists)
+	// the caller owns the returned graph
+	static AdjList* fromBinary(const string& path, CSRFileStatus* status = nullptr)
+	{
+		CSR g;
+		CSRFileHeader header;
+		CSRFileStatus result = mapCSRFile(path, g, header);
+		if (status != nullptr)
+			*status = result;
+		if (result != CSR_FILE_OK)
 			return nullptr;
+
+		return fromCSR(std::move(g), header.directed != 0, header.weighted != 0, header.edges);
+	}
+
+	// makes a graph whose lists hold the rows of g, in the same order, and which keeps g as its CSR
+	// (g has to have both directions of every undirected edge, edge_count counts those once)
+	// every list's nodes are allocated one after the other, so walking a list stays in a few cache lines
+	// the caller owns the returned graph
+	static AdjList* fromCSR(CSR g, bool directed, bool weighted, size_t edge_count)
+	{
+		AdjList* adjlist = new AdjList(0, directed, weighted);
+		size_t n = g.size();
+		adjlist->list_table.reserve(n);
+		adjlist->node_pool.reserve(g.edgeCount());
+		for (size_t i = 0; i < n; i++)
+			adjlist->addList();
+
+		// indices without a vertex in g (e.g. removed before the graph was saved) stay reserved, but get no list
+		adjlist->first_list = adjlist->last_list = nullptr;
+		for (size_t i = 0; i < n; i++)
+		{
+			List* listptr = adjlist->list_table[i];
+			if (!g.exists(i))
+			{
+				adjlist->list_pool.destroy(listptr);
+				adjlist->list_table[i] = nullptr;
+				adjlist->vertices--;
+				continue;
+			}
+
+			listptr->next = nullptr;
+			listptr->prev = adjlist->last_list;
+			if (adjlist->first_list == nullptr)
+				adjlist->first_list = listptr;
+			else
+				adjlist->last_list->next = listptr;
+			adjlist->last_list = listptr;
+
+			for (size_t e = g.edgeBegin(i); e < g.edgeEnd(i); e++)
+				listptr->insert(g.targets[e], g.weights[e]);
 		}
-		return listptr;
+
+		adjlist->edges = edge_count;
+		adjlist->csr = std::move(g);
+		adjlist->csr_valid = true;
+		adjlist->reverse_csr_valid = false;
+		adjlist->connectivity_valid = false;
+		return adjlist;
 	}
 
-	// removes list (removes vertex) from adjacency list
-	// also needs to check all lists for references to that vertex and remove those too
-	bool removeList(size_t index_to_remove)
+	// makes a graph from an edge list, Matrix Market or DIMACS text file (see Import.h), nullptr if it can't be read
+	// the file is parsed on every thread of the default pool, then the edges are counting-sorted into a CSR
+	// that fromCSR() builds the lists from (each list ends up in the order addEdges() would give it)
+	// directed only matters for an edge list, lines that aren't edges and self loops are left out
+	// (report, if given, receives what was left out)
+	// the caller owns the returned graph
+	static AdjList* fromText(const string& path, GraphFileFormat format, bool directed, ImportReport* report = nullptr)
 	{
-		if (first_list == nullptr)
-			return false;
+		ImportedGraph imported;
+		if (!importGraph(path, format, directed, defaultThreadPool(), imported))
+			return nullptr;
+		if (report != nullptr)
+			*report = std::move(imported.report);
+
+		// the importer only gives edges between two different vertices it counted, so nothing is checked again
+		size_t n = imported.vertices;
+		bool weighted = imported.weighted;
+		std::vector<size_t> offsets(n + 1, 0);
+		for (const tuple<size_t, size_t, size_t>& edge : imported.edges)
+		{
+			offsets[get<0>(edge) + 1]++;
+			if (!imported.directed)
+				offsets[get<1>(edge) + 1]++;
+		}
+		for (size_t i = 0; i < n; i++)
+			offsets[i + 1] += offsets[i];
 
-		List* listptr = first_list;
-		List* prevlist = nullptr;
-		while (listptr != nullptr)
+		// next free position in every row, filled in file order
+		std::vector<size_t> targets(offsets[n]), weights(offsets[n]), fill(offsets.begin(), offsets.end() - 1);
+		for (const tuple<size_t, size_t, size_t>& edge : imported.edges)
 		{
-			// only removes if vertex with that index found
-			listptr->remove(index_to_remove);
-			
-			// if this entire list has to be removed
-			if (listptr->list_index == index_to_remove)
+			size_t u = get<0>(edge), v = get<1>(edge);
+			size_t weight = weighted ? std::max(get<2>(edge), (size_t)1) : 1;
+
+			size_t pos = fill[u]++;
+			targets[pos] = v;
+			weights[pos] = weight;
+			if (!imported.directed)
 			{
-				// remove all nodes in the list
-				while (listptr->isEmpty() == false)
-				{
-					ListNode* ptr = listptr->head;
-					listptr->remove(ptr->index);
+				pos = fill[v]++;
+				targets[pos] = u;
+				weights[pos] = weight;
+			}
+		}
 
-					ptr = ptr->next;		
-				}
-				// now remove the list itself
+		size_t edge_count = imported.edges.size();
+		imported.edges = std::vector<tuple<size_t, size_t, size_t>>();
+
+		CSR g;
+		g.assign(std::move(offsets), std::move(targets), std::move(weights), std::vector<unsigned char>(n, 1));
+		return fromCSR(std::move(g), imported.directed, weighted, edge_count);
+	}
+
+	// sends a message to log_sink if one is set
+	// callers check log_sink first so no message is even built while logging is off
+	void log(const string& message)
+	{
+		if (log_sink)
+			log_sink(message);
+	}
+
+	/// search for list with passed index, returns nullptr if there is no such vertex
+	List* findListWithIndex (size_t index)
+	{
+		return (index < list_table.size()) ? list_table[index] : nullptr;
+	}
 
-				// if the first list was the list to remove
-				if (prevlist == nullptr)
+	// takes a list out of the chain and frees it (its nodes have to be removed first)
+	void unchainList(List* listptr)
+	{
+		if (listptr->prev == nullptr)
+			first_list = listptr->next;
+		else
+			listptr->prev->next = listptr->next;
+
+		if (listptr->next == nullptr)
+			last_list = listptr->prev;
+		else
+			listptr->next->prev = listptr->prev;
+
+		list_pool.destroy(listptr);
+	}
+
+	// removes one entry for edge (u -> v) from in_edges[v]
+	void unlinkInEdge(size_t u, size_t v)
+	{
+		vector<size_t>& from = in_edges[v];
+		vector<size_t>::iterator it = std::find(from.begin(), from.end(), u);
+		if (it != from.end())
+		{
+			*it = from.back();
+			from.pop_back();
+		}
+	}
+
+	// removes list (removes vertex) from adjacency list, along with every edge to or from it
+	// only the lists of its neighbours are touched if the graph is undirected or keeps its in-edges (see keepInEdges()),
+	// a directed graph without them has to check all lists for edges to the vertex
+	GraphStatus removeList(size_t index_to_remove)
+	{
+		List* doomed = findListWithIndex(index_to_remove);
+		if (doomed == nullptr)
+		{
+			if (log_sink)
+				log("Node " + to_string(index_to_remove) + " doesn't exist!");
+			return GRAPH_NO_SUCH_VERTEX;
+		}
+
+		csr_valid = false;
+		connectivity_valid = false;
+
+		if (directed == false)
+		{
+			// the other end of every edge has it in its own list
+			for (ListNode* ptr = doomed->head; ptr != nullptr; ptr = ptr->next)
+				list_table[ptr->index]->remove(index_to_remove);
+		}
+		else if (keep_in_edges)
+		{
+			// one entry per edge, so parallel edges are removed once each
+			for (size_t w : in_edges[index_to_remove])
+				list_table[w]->remove(index_to_remove);
+			edges -= in_edges[index_to_remove].size();
+			in_edges[index_to_remove].clear();
+
+			for (ListNode* ptr = doomed->head; ptr != nullptr; ptr = ptr->next)
+				unlinkInEdge(index_to_remove, ptr->index);
+		}
+		else
+		{
+			// repeated, there may be parallel edges to it
+			for (List* listptr = first_list; listptr != nullptr; listptr = listptr->next)
+				if (listptr != doomed)
+					while (listptr->remove(index_to_remove))
+						edges--;
+		}
+
+		// its own edges (an undirected edge is counted once, here)
+		edges -= doomed->list_size;
+		while (doomed->pop_front());
+		unchainList(doomed);
+
+		// the index stays reserved, so later vertices keep their indices
+		list_table[index_to_remove] = nullptr;
+
+		if (keep_topological_order)
+			topological_order.isolateVertex(index_to_remove);
+
+		vertices--;
+		return GRAPH_OK;
+	}
+
+	// removes every vertex in indices, along with their edges, in one pass over the graph
+	// (cheaper than removeList() on each once there are many, that can take a pass for each)
+	// returns GRAPH_OK, or GRAPH_NO_SUCH_VERTEX if an index had no vertex (the others are still removed)
+	GraphStatus removeLists(span<const size_t> indices)
+	{
+		GraphStatus result = GRAPH_OK;
+		vector<bool> doomed(list_counter, false);
+		size_t count = 0;
+		for (size_t index : indices)
+		{
+			if (findListWithIndex(index) == nullptr)
+			{
+				if (log_sink)
+					log("Node " + to_string(index) + " doesn't exist!");
+				result = GRAPH_NO_SUCH_VERTEX;
+			}
+			else if (!doomed[index])
+			{
+				doomed[index] = true;
+				count++;
+			}
+		}
+		if (count == 0)
+			return result;
+
+		csr_valid = false;
+		connectivity_valid = false;
+
+		// survivor_edges = nodes of other lists that lead to a removed vertex, doomed_nodes = nodes of removed lists,
+		// inner_nodes = nodes of removed lists that lead to a removed vertex (an undirected edge has two)
+		size_t survivor_edges = 0, doomed_nodes = 0, inner_nodes = 0;
+		for (List* listptr = first_list; listptr != nullptr; )
+		{
+			List* next_list = listptr->next;
+			if (doomed[listptr->list_index])
+			{
+				size_t index = listptr->list_index;
+				for (ListNode* ptr = listptr->head; ptr != nullptr; ptr = ptr->next)
+					inner_nodes += doomed[ptr->index];
+				doomed_nodes += listptr->list_size;
+
+				while (listptr->pop_front());
+				unchainList(listptr);
+				list_table[index] = nullptr;
+				if (keep_topological_order)
+					topological_order.isolateVertex(index);
+				if (keep_in_edges)
+					in_edges[index].clear();
+			}
+			else
+			{
+				for (ListNode* ptr = listptr->head; ptr != nullptr; )
 				{
-					List* temp = first_list;
-					first_list = first_list->next;
-					delete(temp);
+					ListNode* next_node = ptr->next;
+					if (doomed[ptr->index])
+					{
+						listptr->unlink(ptr);
+						survivor_edges++;
+					}
+					ptr = next_node;
 				}
-				else
+
+				if (keep_in_edges)
 				{
-					List* temp = listptr;
-					prevlist->next = listptr->next;
-					delete(temp);
+					vector<size_t>& from = in_edges[listptr->list_index];
+					from.erase(std::remove_if(from.begin(), from.end(), [&](size_t w) { return doomed[w]; }), from.end());
 				}
 			}
-
-			prevlist = listptr;
-			listptr = listptr->next;
+			listptr = next_list;
 		}
 
-		vertices--;
-		return true;
+		// a directed edge is in its tail's list only, an undirected one in both
+		edges -= directed ? survivor_edges + doomed_nodes : survivor_edges + inner_nodes / 2;
+		vertices -= count;
+		return result;
 	}
 
 	// adds directed edge (u -> v) if adjlist->directed is true, else undirected
 	// REQUIRES NODES WITH INDICES u and v TO EXIST ALREADY
 	// takes in optional weight parameter (only considered if adjlist->weighted is true)
-	void addEdge(size_t u, size_t v, size_t weight = 1)
+	GraphStatus addEdge(size_t u, size_t v, size_t weight = 1)
 	{
 		if (u == v)
 		{
-			cout << "Can't add edge (" << u << ", " << v << ") because can't have an edge to self!\n";
-			return;
+			if (log_sink)
+				log("Can't add edge (" + to_string(u) + ", " + to_string(v) + ") because can't have an edge to self!");
+			return GRAPH_SELF_LOOP;
 		}
 
 		List* list_u = findListWithIndex(u);
@@ -163,150 +514,189 @@ public:
 
 		if (list_u == nullptr || list_v == nullptr)
 		{
-			cout << "One or both of the node indices provided don't exist!";
-			return;	
+			if (log_sink)
+				log("One or both of the node indices provided don't exist!");
+			return GRAPH_NO_SUCH_VERTEX;
 		}
 
 		if (weight < 1 && weighted)
 		{
-			cout << "Invalid weight passed to AdjList::addEdge(), so assuming weight 1\n";
+			if (log_sink)
+				log("Invalid weight passed to AdjList::addEdge(), so assuming weight 1");
 			weight = 1;
 		}
 		else if (weighted == false && weight != 1)
-		{
-			// cout << "Weight passed to AdjList::addEdge() is more than 1 but graph is non-weighted, so assuming weight 1.\n";
 			weight = 1;
+
+		// one lookup in u's list (a hash lookup once it is long), an undirected edge is in both lists or neither
+		if (!allow_parallel_edges && list_u->find(v) != nullptr)
+		{
+			if (log_sink)
+				log("Can't add edge (" + to_string(u) + ", " + to_string(v) + ") because it already exists!");
+			return GRAPH_DUPLICATE_EDGE;
+		}
+
+		if (keep_topological_order && !topological_order.addEdge(u, v))
+		{
+			if (log_sink)
+				log("Can't add edge (" + to_string(u) + ", " + to_string(v) + ") because it would close a cycle!");
+			return GRAPH_CYCLE;
 		}
 
+		csr_valid = false;
+
 		// insert index v in list u 
-		cout << "Inserting edge (" << u << ", " << v << ") with weight " << weight << endl;
+		if (log_sink)
+			log("Inserting edge (" + to_string(u) + ", " + to_string(v) + ") with weight " + to_string(weight));
 
 		list_u->insert(v, weight);
 
 		// if undirected, insert index u in list v also
 		if (directed == false)
 			list_v->insert(u, weight);
+		else if (keep_in_edges)
+			in_edges[v].push_back(u);
+
+		if (connectivity_valid)
+			connectivity.unite(u, v);
 
 		edges++;
+		return GRAPH_OK;
 	}
 
-	// Remove specified edge (u, v) from the AdjList
-	// if graph is undirected, need to remove edge (v, u) also
-	void removeEdge(size_t u, size_t v)
+	// adds every (u, v, weight) edge in edge_list, in order, as if addEdge() was called on each one
+	// returns GRAPH_OK, or the status of the first edge that couldn't be added (the rest are still added)
+	GraphStatus addEdges(span<const tuple<size_t, size_t, size_t>> edge_list)
 	{
-		List* listptr = findListWithIndex(u);
-		if (listptr == nullptr) 
-		{
-			cout << "Edge with specified indices not found !!";
-			return;
-		}
+		// undirected edges take a node in both lists
+		node_pool.reserve(edge_list.size() * (directed ? 1 : 2));
 
-		ListNode* ptr = listptr->head;
-		bool found = false;
-		while (ptr != nullptr)
+		GraphStatus result = GRAPH_OK;
+		for (const tuple<size_t, size_t, size_t>& edge : edge_list)
 		{
-			if (ptr->index == v)
-				found = true;
-			ptr = ptr->next;
+			GraphStatus status = addEdge(get<0>(edge), get<1>(edge), get<2>(edge));
+			if (result == GRAPH_OK)
+				result = status;
 		}
+		return result;
+	}
 
-		if (found)
-		{
-			listptr->remove(v);
-			edges--;
-		}
-		else
+	// returns whether the graph has an edge (u, v) (either way round if it is undirected)
+	// takes a walk of u's list while it is short, a hash lookup once it has LIST_INDEX_THRESHOLD nodes
+	bool hasEdge(size_t u, size_t v)
+	{
+		List* list_u = findListWithIndex(u);
+		return list_u != nullptr && list_u->find(v) != nullptr;
+	}
+
+	// returns the weight of edge (u, v) (of one of them if there are parallel edges), UNREACHABLE if there is none
+	size_t edgeWeight(size_t u, size_t v)
+	{
+		List* list_u = findListWithIndex(u);
+		ListNode* node = (list_u == nullptr) ? nullptr : list_u->find(v);
+		return (node == nullptr) ? UNREACHABLE : node->weight;
+	}
+
+	// Remove specified edge (u, v) from the AdjList
+	// if graph is undirected, need to remove edge (v, u) also
+	GraphStatus removeEdge(size_t u, size_t v)
+	{
+		List* list_u = findListWithIndex(u);
+		List* list_v = findListWithIndex(v);
+
+		// List::remove() finds the node once (through the hash index of a long list) and unlinks it through its back link
+		if (list_u == nullptr || list_v == nullptr || list_u->remove(v) == false)
 		{
-			cout << "Edge with specified indices not found !!";
-			return;
+			if (log_sink)
+				log("Edge with specified indices not found !!");
+			return GRAPH_NO_SUCH_EDGE;
 		}
 
-		if (directed == false)
-		{
-			List* listptr = findListWithIndex(v);
-			ListNode* ptr = listptr->head;
-			bool found = false;
-			while (ptr != nullptr)
-			{
-				if (ptr->index == u)
-					found = true;
-				ptr = ptr->next;
-			}
+		// an undirected edge is stored in both lists but counted once
+		if (directed == false && list_v->remove(u) == false && log_sink)
+			log("UNEXPECTED ERROR IN AdjList::removeEdge(), (" + to_string(v) + ", " + to_string(u) + ") was missing");
 
-			if (found)
-			{
-				listptr->remove(u);
-				edges--;
-			}
-			else
-			{
-				// directed graph but node u not found in v's adjacency list => some problem
-				cout << "UNEXPECTED ERROR IN AdjList::removeEdge()\n";
-				return;
-			}
+		if (keep_topological_order)
+			topological_order.removeEdge(u, v);
+		if (keep_in_edges)
+			unlinkInEdge(u, v);
+
+		edges--;
+		csr_valid = false;
+		connectivity_valid = false;
+		return GRAPH_OK;
+	}
+
+	// returns the CSR form of the graph, rebuilding it first if the graph changed since the last call
+	const CSR& getCSR()
+	{
+		if (!csr_valid)
+		{
+			csr.build(first_list, list_counter);
+			csr_valid = true;
+			reverse_csr_valid = false;
 		}
+		return csr;
 	}
 
-	// utility function for depth-first TRAVERSAL (DISPLAY)
-	void DF_util_show(size_t index, vector<bool> &visited)
+	// returns a compressed copy of the CSR (see CompressedCSR.h), which takes a fraction of its memory
+	// and can be traversed with bfs() and CompressedDFS (weights are only kept if the graph is weighted)
+	CompressedCSR Compressed()
 	{
-		visited[index] = true;
-		cout << index << " ";
+		return CompressedCSR(getCSR(), weighted);
+	}
 
-		/// search for list with passed index, so we can find adjacent nodes
-		List* listptr = findListWithIndex(index);
-		if (listptr == nullptr) { return; }
+	// returns the CSR of the graph with its edges reversed (the CSR itself for undirected graphs)
+	const CSR& getReverseCSR()
+	{
+		const CSR& g = getCSR();
+		if (directed == false)
+			return g;
 
-		/// check all nodes in listptr and push to queue if not visited
-		ListNode* ptr = listptr->head;
-		while(ptr != nullptr)
+		if (!reverse_csr_valid)
 		{
-			if (visited[ptr->index] == false)
-				DF_util_show(ptr->index, visited);
-			ptr = ptr->next;
+			reverse_csr = g.reversed();
+			reverse_csr_valid = true;
 		}
+		return reverse_csr;
+	}
+
+	// utility function for depth-first TRAVERSAL (DISPLAY), prints vertices in the order they are reached
+	void DF_util_show(size_t index, DFS &dfs)
+	{
+		dfs.run(index, [](size_t u)
+		{
+			cout << u << " ";
+			return DFS_CONTINUE;
+		});
 	}
 
 	// Depth-first traversal DISPLAY for the graph
 	void showDFT(size_t ind, bool including_disconnected_nodes)
 	{
 		cout << "DFT: ";
-		vector<bool> visited(vertices);
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
+		const CSR& g = getCSR();
+		DFS dfs(g);
 
 		if(including_disconnected_nodes)
 		{
-			for (size_t i = 0; i < vertices; i++)
-				if (visited[i] == false)
-					DF_util_show(i, visited);
+			for (size_t i = 0; i < g.size(); i++)
+				if (g.exists(i) && dfs.colour[i] == WHITE)
+					DF_util_show(i, dfs);
 		}
-		else
-			DF_util_show(ind, visited);
+		else if (g.exists(ind))
+			DF_util_show(ind, dfs);
 		
 		cout << "\n";
 	}
 
-	// utility function for depth-first SEARCH by index
-	bool DF_util_search(size_t index, size_t search_index, vector<bool> &visited) 
+	// utility function for depth-first SEARCH by index, returns whether search_index is reachable from index
+	bool DF_util_search(size_t index, size_t search_index, DFS &dfs) 
 	{
-		visited[index] = true;
-
-		/// search for list with passed index, so we can find adjacent nodes
-		List* listptr = findListWithIndex(index);
-		if (listptr == nullptr) { return false; }
-
-		/// check all nodes in listptr and push to queue if not visited
-		ListNode* ptr = listptr->head;
-		while(ptr != nullptr)
+		return dfs.run(index, [search_index](size_t u)
 		{
-			if (visited[ptr->index] == false)
-				if(DF_util_search(ptr->index, search_index, visited))
-					return true;
-			ptr = ptr->next;
-		}
-
-		return false; // if not found in any list return false
+			return (u == search_index) ? DFS_STOP : DFS_CONTINUE;
+		});
 	}
 
 	// Depth-first traversal SEARCH for the graph
@@ -315,165 +705,225 @@ public:
 	{
 		cout << "DFT: ";
 		
-		vector<bool> visited(vertices);
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
+		const CSR& g = getCSR();
+		DFS dfs(g);
 
 		if(including_disconnected_nodes)
 		{
-			for (size_t i = 0; i < vertices; i++)
-				if (visited[i] == false)
-					if(DF_util_search(i, search_index, visited))
+			for (size_t i = 0; i < g.size(); i++)
+				if (g.exists(i) && dfs.colour[i] == WHITE)
+					if(DF_util_search(i, search_index, dfs))
 						return true;
 
 			return false;
 		}
+		else if (g.exists(ind))
+			return DF_util_search(ind, search_index, dfs);
 		else
-			return DF_util_search(ind, search_index, visited);
-		
-		// cout << endl; this is never executed anyway since it's after the return
+			return false;
 	}
 
-	// Breadth-first traversal SEARCH for the graph
-	bool searchBFT(size_t u)
+	// breadth-first search from source, returns the number of edges to every vertex and the vertex it was reached from
+	// (switches between top-down and bottom-up steps depending on the size of the frontier)
+	ShortestPaths BFS(size_t source)
 	{
-		cout << "\nBFT: ";
+		const CSR& g = getCSR();
+		return bfs(g, getReverseCSR(), source);
+	}
 
-		vector<bool> visited(vertices);
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
+	// breadth-first search from source that expands every level on all cores, returns the same distances as BFS()
+	ShortestPaths ParallelBFS(size_t source)
+	{
+		return parallelBfs(getCSR(), source, defaultThreadPool());
+	}
 
-		// make a queue
-		// Queue* queue = Queue_init();
-		std::queue<size_t> que;
+	// Breadth-first SEARCH for the graph, returns whether search_index can be reached from start
+	bool searchBFT(size_t search_index, size_t start = 0)
+	{
+		if (!getCSR().exists(search_index))
+			return false;
 
-		List* listptr = findListWithIndex(u);
-		if (listptr == nullptr) { cout << "Invalid starting node for BFS!"; return false; }
-		
-		visited[u] = true;
-		que.push(u);
+		return BFS(start).dist[search_index] != UNREACHABLE;
+	}
 
-		while(que.empty() == false)
+	// returns the union-find of connected vertices, rebuilding it first if an edge or vertex was removed since
+	const UnionFind& getConnectivity()
+	{
+		if (!connectivity_valid)
 		{
-			// pop from queue and check if index we are searching for is found
-			size_t index = que.back(); que.pop();  // TODO: THIS WAS ORIGINALLY INT BUT CHECK IF SIZE_T WORKS AS EXPECTED
-			if (index == u)
-				return true; 
-
-			/// get list whose index = index
-			List* i__listptr = findListWithIndex(index);
-			if (listptr->isEmpty() && listptr->next) 
-			{ 
-				i__listptr = listptr->next;
-				listptr = listptr->next;
-			}
-
-			/// check all nodes in listptr and push to queue if not visited
-			ListNode* ptr = i__listptr->head;
-			if (visited[i__listptr->list_index] == false)
-			{
-				que.push(i__listptr->list_index);
-				visited[i__listptr->list_index] = true;
-			}
-			while(ptr != nullptr)
-			{
-				if (visited[ptr->index] == false)
-				{
-					que.push(ptr->index);
-					visited[ptr->index] = true;
-				}
-				ptr = ptr->next;
-			}
+			const CSR& g = getCSR();
+			connectivity.reset(g.size());
+			for (size_t u = 0; u < g.size(); u++)
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+					connectivity.unite(u, g.targets[e]);
+			connectivity_valid = true;
 		}
+		return connectivity;
+	}
+
+	// RETURNS WHETHER GRAPH IS CONNECTED OR NOT (weakly connected, for a directed graph)
+	// O(1) as long as nothing was removed since the last call
+	bool isConnected()
+	{
+		if (vertices == 0)
+			return true;
 
-		return false; // if not found anywhere in the BFT
+		// every removed vertex is a set of its own
+		return getConnectivity().sets - (list_counter - vertices) == 1;
 	}
 
-	// used for connectivity checking
-	void DFT_util_generalpurpose(size_t index, vector<bool> &visited) // RETURNED BOOL EARLIER, but I don't see the point of bool as returned value was never used
+	// returns whether u and v are in the same connected component
+	bool areConnected(size_t u, size_t v)
 	{
-		visited[index] = true;
+		if (findListWithIndex(u) == nullptr || findListWithIndex(v) == nullptr)
+			return false;
 
-		/// search for list with passed index, so we can find adjacent nodes
-		List* listptr = findListWithIndex(index);
-		if (listptr == nullptr) { return; }// false; }
+		getConnectivity();
+		return connectivity.connected(u, v);
+	}
 
-		/// check all nodes in listptr and push to queue if not visited
-		ListNode* ptr = listptr->head;
-		while(ptr != nullptr)
-		{
-			if (visited[ptr->index] == false)
-				DFT_util_generalpurpose(ptr->index, visited);
-			ptr = ptr->next;
-		}
+	// returns the component id of every vertex and the size of every component (weakly connected, if directed)
+	Components ConnectedComponents()
+	{
+		getConnectivity();
+
+		vector<size_t> label(list_counter);
+		for (size_t v = 0; v < list_counter; v++)
+			label[v] = connectivity.find(v);
+
+		return components_fromLabels(getCSR(), label);
 	}
 
-	// RETURNS WHETHER GRAPH IS CONNECTED OR NOT BY CALLING UTILITY FUNCTIONS
-	bool isConnected()
+	// same components as ConnectedComponents(), computed from scratch on all cores
+	Components ParallelConnectedComponents()
 	{
-		// call util_checkConnectivity_DFT for index 0 and get the visited[] array
-		vector<bool> visited = util_checkConnectivity_DFT(0);
+		return parallelConnectedComponents(getCSR(), defaultThreadPool());
+	}
 
-		// if any node is left unvisited, that means graph is disconnected
-		for(size_t i = 0; i < vertices; i++)
-			if (visited[i] == false)
-				return false;
-		
-		// if all visited, graph is connected
-		return true;
+	// returns the strongly connected component of every vertex and the size of every component (Tarjan's algorithm)
+	// (the same as the connected components for an undirected graph)
+	Components StronglyConnectedComponents()
+	{
+		return tarjanSCC(getCSR());
 	}
 
-	// utility function that uses DFT, USED FOR CHECKING GRAPH CONNECTIVITY
-	vector<bool> util_checkConnectivity_DFT(size_t ind)
+	// same components as StronglyConnectedComponents(), found with forward and backward searches on all cores
+	Components ParallelStronglyConnectedComponents()
 	{
-		vector<bool> visited(vertices);
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
+		const CSR& g = getCSR();
+		return parallelSCC(g, getReverseCSR(), defaultThreadPool());
+	}
 
-		// just call once for passed index
-		DFT_util_generalpurpose(ind, visited);
-		
-		return visited;
+	// returns whether every vertex can be reached from every other vertex
+	bool isStronglyConnected()
+	{
+		return StronglyConnectedComponents().count() <= 1;
 	}
 
-	// utility function that uses DFT, called by AdjList::isCyclic()
-	bool util_checkCylic_DFT(size_t u, vector<int> &colour)
+	// builds the condensation of the graph: a directed graph with vertex c for component c of scc,
+	// and an edge (a, b) wherever an edge leads from component a to component b (the lightest one, if several do)
+	// the condensation has no cycles, so it can always be sorted topologically
+	// scc = StronglyConnectedComponents() or ParallelStronglyConnectedComponents() of this graph
+	// the caller owns the returned graph
+	AdjList* Condensation(const Components& scc)
 	{
-		colour[u] = GRAY;
+		AdjList* dag = new AdjList(scc.count(), true, weighted);
+		dag->addEdges(condensationEdges(getCSR(), scc));
+		return dag;
+	}
 
-		/// search for list with passed index, so we can find adjacent nodes
-		List* listptr = findListWithIndex(u);
-		if (listptr == nullptr) { return false; }
+	// builds a copy of the graph with its vertices renumbered for locality (see Reorder.h),
+	// so traversals of the copy touch fewer cache lines
+	// original_id receives the index in this graph of every vertex of the copy (removed indices are left out)
+	// the caller owns the returned graph
+	AdjList* Reordered(VertexOrdering method, vector<size_t>& original_id)
+	{
+		const CSR& g = getCSR();
+		const CSR& in = getReverseCSR();
+		original_id = (method == ORDER_RCM) ? reverseCuthillMcKee(g, in) : degreeOrder(g, in);
 
-		/// check all nodes in listptr and push to queue if not visited
-		ListNode* ptr = listptr->head;
-		while(ptr != nullptr)
-		{
-			if(colour[ptr->index] == GRAY)
-				return true;
-			
-			if((colour[ptr->index] == WHITE) && util_checkCylic_DFT(ptr->index, colour))
-				return true;
+		AdjList* result = new AdjList(original_id.size(), directed, weighted);
+		result->addEdges(relabelledEdges(g, original_id, directed));
+		return result;
+	}
 
-			ptr = ptr->next;
+	// utility function that uses DFT, called by AdjList::isCyclic()
+	// an edge back to a GRAY vertex (one still on the DFS stack) means we found a cycle
+	bool util_checkCylic_DFT(size_t u, DFS &dfs)
+	{
+		return dfs.run(u, DFSNoPreHook(), DFSNoHook(), [](size_t, size_t) { return true; });
+	}
+
+	// starts (keep = true) or stops keeping a topological order of a directed graph up to date as it changes
+	// while it is kept, addEdge() refuses any edge that would close a cycle (with GRAPH_CYCLE),
+	// looking only at the vertices between the edge's ends in the current order
+	// returns GRAPH_DIRECTED for an undirected graph, GRAPH_CYCLE if the graph already has a cycle
+	GraphStatus keepTopologicalOrder(bool keep)
+	{
+		if (!keep)
+		{
+			keep_topological_order = false;
+			topological_order.clear();
+			return GRAPH_OK;
 		}
+		if (directed == false)
+			return GRAPH_DIRECTED;
 
-		colour[u] = BLACK;
+		TopologicalOrder topo = KahnTopologicalSort();
+		if (!topo.acyclic)
+			return GRAPH_CYCLE;
 
-		return false;
+		const CSR& g = getCSR();
+		topological_order.assign(g.size(), topo.order);
+		for (size_t u = 0; u < g.size(); u++)
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				topological_order.addEdge(u, g.targets[e]);
+
+		keep_topological_order = true;
+		return GRAPH_OK;
+	}
+
+	// starts (keep = true) or stops keeping the in-edges of every vertex of a directed graph,
+	// so that removeList() only has to touch a vertex's neighbours instead of every list
+	// (an undirected graph doesn't need them, its lists already hold both directions of every edge)
+	void keepInEdges(bool keep)
+	{
+		in_edges.clear();
+		keep_in_edges = keep && directed;
+		if (!keep_in_edges)
+			return;
+
+		in_edges.resize(list_counter);
+		for (List* listptr = first_list; listptr != nullptr; listptr = listptr->next)
+			for (ListNode* ptr = listptr->head; ptr != nullptr; ptr = ptr->next)
+				in_edges[ptr->index].push_back(listptr->list_index);
+	}
+
+	// the topological order kept by keepTopologicalOrder(), every vertex before all vertices its edges lead to
+	vector<size_t> CurrentTopologicalOrder()
+	{
+		vector<size_t> order;
+		if (!keep_topological_order)
+			return order;
+
+		for (size_t v : topological_order.vertex_at)
+			if (findListWithIndex(v) != nullptr)
+				order.push_back(v);
+		return order;
 	}
 
 	// returns whether the graph contains a cycle or not
 	bool isCyclic()
 	{
-		// cout << "Inside AdjList_isCyclic!\n");
-		vector<int> colour(vertices);
+		// the kept order is proof there is none
+		if (keep_topological_order)
+			return false;
 
-		for (size_t i = 0; i < vertices; i++)
-			colour[i] = WHITE;
+		const CSR& g = getCSR();
+		DFS dfs(g);
 
-		for (size_t i = 0; i < vertices; i++)
-			if (colour[i] == WHITE && util_checkCylic_DFT(i, colour))
+		for (size_t i = 0; i < g.size(); i++)
+			if (g.exists(i) && dfs.colour[i] == WHITE && util_checkCylic_DFT(i, dfs))
 				return true;
 		
 		return false;
@@ -484,72 +934,49 @@ public:
 	{
 		cout << "\nBFT: ";
 
-		vector<bool> visited(vertices);
+		const CSR& g = getCSR();
+		if (!g.exists(u)) { cout << "Invalid starting node for BFS!"; return; }
+
+		vector<bool> visited(g.size(), false);
 
 		// make a queue
 		std::queue<size_t> que;
 		
-		List* listptr = findListWithIndex(u);
-		if (listptr == nullptr) { cout << "Invalid starting node for BFS!"; return; }
-		
 		visited[u] = true;
 		que.push(u);
 		
 		while(que.empty() == false)
 		{
 			// pop from queue and display
-			size_t index = que.front(); que.pop();		// TODO: THIS WAS ORIGINALLY INT BUT CHECK IF SIZE_T WORKS AS EXPECTED
+			size_t index = que.front(); que.pop();
 
-			// if (index != -1)	// commented this out for now as size_t cannot be compared to negative number -1
 			cout << index << " ";
 
-			/// get list whose index = index
-			List* i__listptr = findListWithIndex(index);
-
-			/// if current i__listptr is empty, no path to go from here
-			if (i__listptr->isEmpty())
-				continue;
-
-			/// check all nodes in listptr and push to queue if not visited
-			ListNode* ptr = i__listptr->head;
-			if (visited[i__listptr->list_index] == false)
+			/// check all neighbours of index and push to queue if not visited
+			for (size_t e = g.edgeBegin(index); e < g.edgeEnd(index); e++)
 			{
-				// cout << "%d wasn't in queue! adding...\n", i__listptr->list_index);
-				que.push(i__listptr->list_index);
-				visited[i__listptr->list_index] = true;
-			}
-
-			while(ptr != nullptr)
-			{
-				if (visited[ptr->index] == false)
+				size_t v = g.targets[e];
+				if (visited[v] == false)
 				{
-					que.push(ptr->index);
-					visited[ptr->index] = true;
-				}				
-				ptr = ptr->next;
+					que.push(v);
+					visited[v] = true;
+				}
 			}
 		}
 		cout << "\n";
 	}
 
-	void util_TopologicalSort(size_t v, vector<bool> &visited, std::stack<size_t> &stac)
+	// topological order of the graph (Kahn's algorithm), or a cycle if it has one, see TopologicalOrder
+	// the order also comes split into waves of vertices that don't depend on each other
+	TopologicalOrder KahnTopologicalSort()
 	{
-		visited[v] = true;
-		List* listptr = findListWithIndex(v);
-		if (listptr == nullptr) { cout << "listptr is null in util_TopologicalSort!\n"; return; }
-		
-		ListNode* ptr = listptr->head;
-		while (ptr != nullptr)
-		{
-			if (visited[ptr->index] == false)
-			{
-				// cout << "util_TopologicalSort on index %d\n", ptr->index);
-				util_TopologicalSort(ptr->index, visited, stac);
-			}
-			ptr = ptr->next;
-		}
+		return kahnTopologicalSort(getCSR());
+	}
 
-		stac.push(v);
+	// same result as KahnTopologicalSort(), every wave expanded on all cores
+	TopologicalOrder ParallelTopologicalSort()
+	{
+		return kahnTopologicalSort(getCSR(), &defaultThreadPool());
 	}
 
 	// Topological sort traversal display for the graph
@@ -561,257 +988,141 @@ public:
 			return;
 		}
 
-		if (isCyclic())
+		TopologicalOrder topo = KahnTopologicalSort();
+		if (!topo.acyclic)
 		{
-			cout << "Graph contains cycle, can't do topological sort!";
+			cout << "Graph contains cycle, can't do topological sort!\nCycle: ";
+			for (size_t v : topo.cycle)
+				cout << v << " -> ";
+			cout << topo.cycle[0] << "\n";
 			return;
 		}
-		
-		vector<bool> visited(vertices);
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
-
-		std::stack<size_t> stac;
 
-		// cout << "No of vertices: %d\n", adjlist->vertices);
-		for (size_t i = 0; i < vertices; i++)
-			if (visited[i] == false)
-				util_TopologicalSort(i, visited, stac);
-		
-		// cout << "Stack: "); Stack_show(stack); cout << "\n");
 		cout << "Topological Sort: ";
-		while(stac.empty() == false)
+		for (size_t v : topo.order)
+			cout << v << " ";
+
+		cout << "\nWaves (nodes in one wave don't depend on each other): ";
+		for (size_t w = 0; w < topo.waves(); w++)
 		{
-			cout << stac.top() << " ";
-			stac.pop();
+			cout << "[ ";
+			for (size_t i = topo.wave_start[w]; i < topo.wave_start[w + 1]; i++)
+				cout << topo.order[i] << " ";
+			cout << "] ";
 		}
 		cout << "\n\n";
 	}
 
+	// calculates shortest paths from one source to every other vertex using Dijkstra's algorithm
+	// (radix_heap = use a radix heap instead of a binary heap)
+	ShortestPaths Dijkstra(size_t source, bool radix_heap = false)
+	{
+		return dijkstra(getCSR(), source, radix_heap);
+	}
+
 	// calculates shortest path for all pairs using Floyd-Warshall algorithm
 	void FloydWarshall (bool fixedSource)
 	{
-		size_t** dist =  new size_t*[vertices];
-		for (size_t i = 0; i < vertices; i++)
-			dist[i] =  new size_t[vertices];  
-
-		int** paths = new int*[vertices]; 
-		for (size_t i = 0; i < vertices; i++)
-			paths[i] =  new int[vertices];
-
-		for(size_t i = 0; i < vertices; i++)
-			for (size_t j = 0; j < vertices; j++)
-			{
-				dist[i][j] = INF;
-				paths[i][j] = INF;
-			}
-
-		size_t i = 0, j = 0;
-		List* listptr = first_list;
-		while(listptr != nullptr)
-		{
-			i = listptr->list_index;
-
-			ListNode* ptr = listptr->head;
-			while(ptr != nullptr)
-			{
-				j = ptr->index;
-
-				dist[i][j] = ptr->weight; // weight of path from i to j
-				
-				ptr = ptr->next;
-			}
-
-			listptr = listptr->next;
-		}
-
-		for (size_t k = 0; k < vertices; k++)
-			for (size_t i = 0; i < vertices; i++)
-				for (size_t j = 0; j < vertices; j++)
-				{
-					if (dist[i][k] != INF && dist[k][j] != INF
-					&& (dist[i][k] + dist[k][j]) < dist[i][j])
-					{
-						dist[i][j] = dist[i][k] + dist[k][j];
-						paths[i][j] = k;
-					}
-				}
-		for (size_t i = 0; i < vertices; i++)
-			for (size_t j = 0; j < vertices; j++)
-				if ((dist[i][j] != INF) && (paths[i][j] == INF))
-					paths[i][j] = -1;
-
-		/* printing Dist and Paths matrices for debug purposes
-		// cout << "Dist matrix:\n");	
-		// for (size_t i = 0; i < vertices; i++) 
-		// { 
-		//     for (size_t j = 0; j < vertices; j++) 
-		//     {
-		//         if (dist[i][j] == INF) 
-		//             cout << "%7s", "INF"; 
-		//         else
-		//             cout << "%7d", dist[i][j]; 
-		//     }
-		//     cout << "\n"; 
-		// } 
-
-		// cout << "Paths matrix:\n";
-		// for (size_t i = 0; i < vertices; i++) 
-		// { 
-		//     for (size_t j = 0; j < vertices; j++) 
-		//     {
-		//         if (paths[i][j] == INF) 
-		//             cout << "%7s", "INF"; 
-		//         else
-		//             cout << "%7d", paths[i][j]; 
-		//     }
-		//     cout << "\n"; 
-		// } 
-		*/
+		// matrices are indexed by vertex index, so they span removed indices too
+		AllPairsPaths ap = floydWarshall(getCSR());
 		
 		cout << "Actual paths with shortest distances"
 			 << " between every pair of vertices \n";
-		printShortestPath(paths, dist, vertices, fixedSource);
+		printShortestPath(ap, fixedSource);
 	}
 
-	// utility function to print the constructed MST stored in parent[] 
-	void printMST(vector<int> parent) 
+	// calculates shortest path for all pairs on every core with the blocked Floyd-Warshall
+	// (same distances and paths as FloydWarshall(), see allPairsDijkstra() for a faster pass over sparse graphs)
+	AllPairsPaths AllPairsShortestPaths()
+	{
+		return allPairsShortestPaths(getCSR(), defaultThreadPool());
+	}
+
+	// utility function to print the edges of a constructed MST
+	void printMST(const SpanningTree &mst) 
 	{ 
 		cout << "Edge \tWeight\n"; 
-		List* listptr = first_list;
-		
-		for (size_t i = 0; i < vertices; i++) 
-		{
-			List* listptr = findListWithIndex(i);
-			ListNode* ptr = listptr->head;
-			while (ptr != nullptr)
-			{
-				if (ptr->index == parent[i])
-					printf("%d - %zu \t%zu \n", parent[i], i, ptr->weight);
-				
-				ptr = ptr->next;
-			}
-		}
+		for (const MSTEdge &edge : mst.edges)
+			printf("%zu - %zu \t%zu \n", edge.u, edge.v, edge.weight);
 	}
 	
-	// Constructs and prints MST for the graph
-	void Prim_MST() 
+	// Constructs the MST of the graph with Prim's algorithm into mst
+	// returns GRAPH_DIRECTED or GRAPH_DISCONNECTED if the graph has no minimum spanning tree
+	GraphStatus Prim_MST(SpanningTree &mst) 
 	{
-		if (isConnected() == false)
-		{
-			cout << "Graph needs to be connected for it to have a minimum spanning tree!";
-			return;
-		}
 		if (directed)
-		{
-			cout << "Graph needs to be undirected for it to have a minimum spanning tree!";
-			return;
-		}
-
-		// To store constructed MST
-		vector<int> parent(vertices); 
-		
-		// Key values used to pick minimum weight edge 
-		vector<size_t> key(vertices);
-
-		// To represent set of vertices included in MST
-		vector<bool> included_vertices(vertices);
-
-		// Initialize all keys as INF 
-		for (int i = 0; i < vertices; i++) 
-		{
-			key[i] = INF;
-			included_vertices[i] = false; 
-		}
-	
-		// Make key 0 so that first vertex is picked in the first iteration (since all others are INF) 
-		key[0] = 0; 
-
-		// since first node has no parent
-		parent[0] = -1; 
-	
-		// The MST will have V vertices 
-		List* listptr = first_list;
-		if (listptr)
-		while (listptr->next != nullptr) 
-		{ 
-			// Pick the minimum key vertex from the 
-			// set of vertices not yet included in MST 
-			size_t u = minKey(key, included_vertices, vertices); 
-
-			included_vertices[u] = true; 
-
-			// Update key value and parent index of all vertices adjacent to the picked vertex
-			ListNode* ptr = listptr->head;
-			while(ptr != nullptr)
-			{
-				// Update the key only if ptr->weight is smaller than key[v] and v is not in the List
-				if (included_vertices[ptr->index] == false && ptr->weight < key[ptr->index])
-					parent[ptr->index] = (int)u, key[ptr->index] = ptr->weight; 
+			return GRAPH_DIRECTED;
+		if (isConnected() == false)
+			return GRAPH_DISCONNECTED;
 
-				ptr = ptr->next;
-			}
-			listptr = listptr->next;
-		} 
+		mst.edges.clear();
+		mst.total_weight = 0;
 
-		/* just displaying parent array and included_vertices array for debug purposes
+		const CSR& g = getCSR();
+		if (vertices == 0)
+			return GRAPH_OK;
 
-		// cout << "parent array:\n");
-		// for(int i=0;i<adjlist->vertices;i++)
-		// 	cout << "%d ", parent[i]);
-		// cout << "\n");
+		// start from the first vertex that still exists
+		size_t root = 0;
+		while (!g.exists(root))
+			root++;
 
-		// cout << "included_vertices array:\n");
-		// for(int i=0;i<adjlist->vertices;i++)
-		// 	cout << "%d ", included_vertices[i]);
-		// cout << "\n");
-		*/
-		
-		printMST(parent); 
+		mst = prim(g, root);
+		return GRAPH_OK;
 	} 
 
-	void Util_printAllPathsForGivenSourceAndDest (size_t u, size_t v, vector<bool> &visited, vector<size_t> &paths, size_t &path_index)
+	// Constructs a minimum spanning forest (one tree per connected component) with Kruskal's algorithm,
+	// sorting the edges on all cores
+	GraphStatus Kruskal_MST(SpanningTree &mst)
 	{
-		visited[u] = true; 
-		paths[path_index] = u; 
-		(path_index)++; 
+		if (directed)
+			return GRAPH_DIRECTED;
 
-		if (u == v) 
-		{ 
-			for (size_t i = 0; i < (path_index); i++) 
-				cout << paths[i] << " "; 
-			cout << "\n";
-		} 
-		else // If current vertex is not destination 
-		{ 
-			// Recur for all the vertices adjacent to current vertex 
-			List* listptr = findListWithIndex(u);
-			ListNode* ptr = listptr->head;
-			while (ptr != nullptr)
-			{
-				if (!visited[ptr->index]) 
-					Util_printAllPathsForGivenSourceAndDest(ptr->index, v, visited, paths, path_index); 
-				ptr = ptr->next;
-			} 
-		}
+		mst = kruskal(getCSR(), &defaultThreadPool());
+		return GRAPH_OK;
+	}
 
-		// Remove current vertex from path[] and mark it as unvisited 
-		(path_index)--; 
-		visited[u] = false; 
+	// Constructs a minimum spanning forest (one tree per connected component) with Borůvka's algorithm on all cores
+	GraphStatus Boruvka_MST(SpanningTree &mst)
+	{
+		if (directed)
+			return GRAPH_DIRECTED;
+
+		mst = boruvka(getCSR(), defaultThreadPool());
+		return GRAPH_OK;
 	}
 
-	// print all paths for a given source and destination
-	void printAllPaths (size_t u, size_t v)
+	// calls emit(path) for every simple path from u to v (path = its vertices, u first) until one of limits is hit
+	// or emit returns true, paths are found one at a time and never stored
+	// returns why it ended
+	template <class Emit>
+	PathsEnd EnumeratePaths(size_t u, size_t v, const PathLimits& limits, Emit&& emit)
 	{
-		vector<bool> visited(vertices);
+		const CSR& g = getCSR();
+		return enumeratePaths(g, getReverseCSR(), u, v, limits, emit);
+	}
 
-		for (size_t i = 0; i < vertices; i++)
-			visited[i] = false;
+	// the k shortest simple paths from u to v, shortest first (Yen's algorithm)
+	vector<WeightedPath> KShortestPaths(size_t u, size_t v, size_t k)
+	{
+		return yenKShortestPaths(getCSR(), u, v, k);
+	}
 
-		vector<size_t> paths(vertices);
-		size_t path_index = 0;
+	// print all paths for a given source and destination (as many as limits allow)
+	void printAllPaths (size_t u, size_t v, const PathLimits& limits = PathLimits())
+	{
+		PathsEnd end = EnumeratePaths(u, v, limits, [](const vector<size_t>& path)
+		{
+			for (size_t x : path)
+				cout << x << " ";
+			cout << "\n";
+			return false;
+		});
 
-		Util_printAllPathsForGivenSourceAndDest(u, v, visited, paths, path_index);
+		if (end == PATHS_MAX_PATHS)
+			cout << "(stopped after " << limits.max_paths << " paths)\n";
+		else if (end == PATHS_TIME_BUDGET)
+			cout << "(stopped after " << limits.time_budget << " seconds)\n";
 	}
 
 	void show ()
@@ -830,6 +1141,46 @@ public:
 
 };
 
+// returns a short description of a GraphStatus
+const char* statusMessage(GraphStatus status)
+{
+	switch (status)
+	{
+	case GRAPH_OK:
+		return "OK";
+	case GRAPH_NO_SUCH_VERTEX:
+		return "node doesn't exist";
+	case GRAPH_NO_SUCH_EDGE:
+		return "edge doesn't exist";
+	case GRAPH_SELF_LOOP:
+		return "can't have an edge to self";
+	case GRAPH_DIRECTED:
+		return "graph needs to be undirected";
+	case GRAPH_DISCONNECTED:
+		return "graph needs to be connected";
+	case GRAPH_CYCLE:
+		return "graph can't have a cycle";
+	case GRAPH_FILE_ERROR:
+		return "file can't be read or written";
+	case GRAPH_DUPLICATE_EDGE:
+		return "edge already exists";
+	}
+	return "unknown status";
+}
+
+// prints the vertices of every component
+void printComponents(const Components& cc)
+{
+	for (size_t c = 0; c < cc.count(); c++)
+	{
+		cout << "Component " << c << " (" << cc.sizes[c] << " nodes): ";
+		for (size_t v = 0; v < cc.id.size(); v++)
+			if (cc.id[v] == c)
+				cout << v << " ";
+		cout << "\n";
+	}
+}
+
 // bool, returns true if direct edge from idx to j, otherwise false
 bool printPath_util(size_t idx, size_t j, int** paths, size_t start, size_t end)
 {
@@ -873,6 +1224,27 @@ void printPath(size_t idx, int** paths, size_t dist[], size_t n)
 	}
 }
 
+// prints the path and path cost to every vertex reachable from sp.source
+void printPath(const ShortestPaths& sp)
+{
+	vector<size_t> path;
+	for (size_t j = 0; j < sp.dist.size(); j++)
+	{
+		if (sp.dist[j] == UNREACHABLE || j == sp.source)
+			continue;
+
+		// walk the parents back to the source, then print them in reverse
+		path.clear();
+		for (size_t v = j; v != NO_PARENT; v = sp.parent[v])
+			path.push_back(v);
+
+		printf("From node %zu to node %zu (path cost = %zu):", sp.source, j, sp.dist[j]);
+		for (size_t i = path.size(); i > 0; i--)
+			printf(" %zu", path[i - 1]);
+		cout << "\n";
+	}
+}
+
 void printShortestPath_fixedNode(size_t idx, int** paths, size_t** dist, size_t n)
 {
 	printPath(idx, paths, dist[idx], n);
@@ -901,17 +1273,19 @@ void printShortestPath(int** paths, size_t** dist, size_t n, bool fixedSource)
     }
 }
 
-// util function that finds vertex with minimum key value, from included_vertices set 
-size_t minKey(std::vector<size_t> key, vector<bool> included_vertices, size_t V) 
-{ 
-    // Initialize min value 
-    size_t min = INF, min_index;
-  
-    for (int v = 0; v < V; v++) 
-        if (included_vertices[v] == false && key[v] < min) 
-            min = key[v], min_index = v; 
-  
-    return min_index; 
+// prints the paths held in the flat matrices of an all-pairs result
+void printShortestPath(AllPairsPaths& ap, bool fixedSource)
+{
+	// row pointers into the contiguous matrices
+	vector<size_t*> dist(ap.n);
+	vector<int*> paths(ap.n);
+	for (size_t i = 0; i < ap.n; i++)
+	{
+		dist[i] = &ap.dist[i * ap.n];
+		paths[i] = &ap.paths[i * ap.n];
+	}
+
+	printShortestPath(paths.data(), dist.data(), ap.n, fixedSource);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,166 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <stdint.h>
+#include <bit>
+#include <vector>
+#include <utility>
+
+// binary min-heap of vertex indices 0 .. n-1 keyed by size_t, with decrease-key
+// pos[] remembers where every vertex sits in the heap so its key can be lowered in O(log n)
+// keys are stored next to the vertices in the heap array so sifting doesn't jump around memory
+class IndexedHeap
+{
+	static constexpr size_t NOT_IN_HEAP = SIZE_MAX;
+
+	struct Entry
+	{
+		size_t key;
+		size_t vertex;
+	};
+
+	std::vector<Entry> heap;
+	std::vector<size_t> pos;
+
+	// moves entry up from position i until its parent is not bigger
+	void siftUp(size_t i, Entry entry)
+	{
+		while (i > 0)
+		{
+			size_t parent = (i - 1) / 2;
+			if (heap[parent].key <= entry.key)
+				break;
+			heap[i] = heap[parent];
+			pos[heap[i].vertex] = i;
+			i = parent;
+		}
+		heap[i] = entry;
+		pos[entry.vertex] = i;
+	}
+
+	// moves entry down from position i until no child is smaller
+	void siftDown(size_t i, Entry entry)
+	{
+		size_t n = heap.size();
+		while (true)
+		{
+			size_t child = 2 * i + 1;
+			if (child >= n)
+				break;
+			if (child + 1 < n && heap[child + 1].key < heap[child].key)
+				child++;
+			if (entry.key <= heap[child].key)
+				break;
+
+			heap[i] = heap[child];
+			pos[heap[i].vertex] = i;
+			i = child;
+		}
+		heap[i] = entry;
+		pos[entry.vertex] = i;
+	}
+
+public:
+	// n = number of vertex indices that may be pushed
+	IndexedHeap(size_t n) : pos(n, NOT_IN_HEAP)
+	{
+		heap.reserve(n);
+	}
+
+	bool empty() const { return heap.empty(); }
+	bool contains(size_t v) const { return pos[v] != NOT_IN_HEAP; }
+
+	// key of the vertex at the top of the heap
+	size_t topKey() const { return heap[0].key; }
+
+	// inserts v with key k, or lowers the key of v to k if v is already in the heap with a bigger key
+	// returns whether anything changed
+	bool pushOrDecrease(size_t v, size_t k)
+	{
+		size_t i = pos[v];
+		if (i == NOT_IN_HEAP)
+		{
+			i = heap.size();
+			heap.push_back(Entry{k, v});
+		}
+		else if (k >= heap[i].key)
+			return false;
+
+		siftUp(i, Entry{k, v});
+		return true;
+	}
+
+	// removes and returns the vertex with the smallest key
+	size_t pop()
+	{
+		size_t top = heap[0].vertex;
+		pos[top] = NOT_IN_HEAP;
+
+		Entry last = heap.back();
+		heap.pop_back();
+		if (!heap.empty())
+			siftDown(0, last);
+		return top;
+	}
+};
+
+// monotone priority queue for integer keys (radix heap)
+// keys pushed must never be smaller than the last key popped, which holds for Dijkstra with non-negative weights
+// an entry with key k lives in the bucket numbered by the highest bit in which k differs from the last popped key,
+// so every entry moves between buckets at most 64 times in total
+class RadixHeap
+{
+	std::vector<std::pair<size_t, size_t>> buckets[65];
+	size_t last_key;
+	size_t count;
+
+	static size_t bucketFor(size_t k, size_t last)
+	{
+		return (k == last) ? 0 : 64 - std::countl_zero((uint64_t)(k ^ last));
+	}
+
+public:
+	RadixHeap()
+	{
+		last_key = 0;
+		count = 0;
+	}
+
+	bool empty() const { return count == 0; }
+
+	// inserts value v with key k (k >= last popped key)
+	void push(size_t k, size_t v)
+	{
+		buckets[bucketFor(k, last_key)].push_back(std::make_pair(k, v));
+		count++;
+	}
+
+	// removes and returns a (key, value) pair with the smallest key
+	std::pair<size_t, size_t> pop()
+	{
+		if (buckets[0].empty())
+		{
+			// find the first non-empty bucket and redistribute it around its minimum
+			size_t i = 1;
+			while (buckets[i].empty())
+				i++;
+
+			size_t new_last = buckets[i][0].first;
+			for (const std::pair<size_t, size_t>& entry : buckets[i])
+				if (entry.first < new_last)
+					new_last = entry.first;
+
+			last_key = new_last;
+			for (const std::pair<size_t, size_t>& entry : buckets[i])
+				buckets[bucketFor(entry.first, last_key)].push_back(entry);
+			buckets[i].clear();
+		}
+
+		std::pair<size_t, size_t> top = buckets[0].back();
+		buckets[0].pop_back();
+		count--;
+		return top;
+	}
+};
+
+#endif
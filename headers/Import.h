@@ -0,0 +1,391 @@
+#ifndef IMPORT_H
+#define IMPORT_H
+
+#include "CSRFile.h"
+#include "ThreadPool.h"
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// text formats graphs can be imported from
+// FORMAT_EDGE_LIST     = one "u v" or "u v weight" per line, 0-based, '#' and '%' start comments (SNAP style),
+//                        ids spread much wider than the edges could fill are renumbered (see import_compactIds())
+// FORMAT_MATRIX_MARKET = "%%MatrixMarket matrix coordinate ..." header, a "rows columns entries" line,
+//                        then one "i j" or "i j value" per line, 1-based (symmetric matrices are undirected,
+//                        complex ones can't be read)
+// FORMAT_DIMACS        = "p sp vertices arcs" line, then one "a u v weight" per arc, 1-based, 'c' starts comments
+enum GraphFileFormat {FORMAT_EDGE_LIST, FORMAT_MATRIX_MARKET, FORMAT_DIMACS};
+
+// what an import left out of the graph
+struct ImportReport
+{
+	// lines that should have held an edge but couldn't be read (e.g. a missing number, or anything after the weight),
+	// and the number of the first of them in the file (counted from 1, 0 if every line could be read)
+	size_t bad_lines = 0;
+	size_t first_bad_line = 0;
+
+	// edges from a vertex to itself
+	size_t self_loops = 0;
+
+	// edges whose weight isn't a whole number from 1 (e.g. 0.2, -3 or 1e30), which would have to be rounded to be kept
+	size_t bad_weights = 0;
+
+	// the id in the file of every vertex, if they were renumbered (empty if the ids were kept)
+	std::vector<size_t> original_id;
+};
+
+// edges read from a text file, ready for AdjList::addEdges()
+struct ImportedGraph
+{
+	size_t vertices;
+	bool directed;
+	bool weighted;
+	std::vector<std::tuple<size_t, size_t, size_t>> edges;
+
+	ImportReport report;
+};
+
+// the file is split into this many chunks per thread, so threads that finish early can take more
+const size_t IMPORT_CHUNKS_PER_THREAD = 4;
+
+// edge list ids below this are always kept as they are, a small hand-written file keeps its numbering
+const size_t IMPORT_DENSE_IDS = 1 << 16;
+
+// returns whether p ends a number: the end of the data, a space or the end of a line
+inline bool import_numberEnds(const char* p, const char* end)
+{
+	return p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n';
+}
+
+// reads an unsigned whole number at p (after any spaces or tabs), moves p past it, returns false if there is none
+// (vertex ids and header counts, so "1.5" or "1e3" isn't one)
+inline bool import_readNumber(const char*& p, const char* end, size_t& value)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+
+	std::from_chars_result result = std::from_chars(p, end, value);
+	if (result.ec != std::errc() || !import_numberEnds(result.ptr, end))
+		return false;
+
+	p = result.ptr;
+	return true;
+}
+
+// reads an edge weight at p like import_readNumber(), but also takes a real number ("3.0", "1e3"),
+// returns false if there is no number at all
+// kept is set to whether the graph can hold the weight unchanged (a whole number from 1 that fits in a size_t),
+// weights aren't rounded (see ImportReport::bad_weights)
+inline bool import_readWeight(const char*& p, const char* end, size_t& weight, bool& kept)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+
+	std::from_chars_result result = std::from_chars(p, end, weight);
+	if (import_numberEnds(result.ptr, end) && result.ec != std::errc::invalid_argument)
+	{
+		kept = (result.ec == std::errc() && weight >= 1);
+		p = result.ptr;
+		return true;
+	}
+
+	double real;
+	result = std::from_chars(p, end, real);
+	if (result.ec == std::errc::invalid_argument || !import_numberEnds(result.ptr, end))
+		return false;
+
+	// 2^64 is the first double past SIZE_MAX
+	kept = (result.ec == std::errc() && real >= 1 && real < 18446744073709551616.0 && real == floor(real));
+	weight = kept ? (size_t)real : 0;
+	p = result.ptr;
+	return true;
+}
+
+// returns whether only spaces are left before the end of the line at p
+inline bool import_lineEnds(const char* p, const char* end)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		p++;
+	return p == end || *p == '\n';
+}
+
+// parses the edge lines of [begin, end) (which starts at a line and ends after one) into edges
+// base = the number of the first vertex in the file (0 or 1), limit = the number of vertices it declares
+// (SIZE_MAX if it doesn't), lines naming a vertex past that are bad lines
+// lines gets the number of lines in the chunk, and report.first_bad_line counts from the chunk's first line
+inline void import_parseChunk(const char* begin, const char* end, GraphFileFormat format, size_t base, size_t limit,
+	std::vector<std::tuple<size_t, size_t, size_t>>& edges, ImportReport& report, size_t& lines, bool& weighted,
+	size_t& max_vertex)
+{
+	auto badLine = [&]()
+	{
+		if (report.bad_lines++ == 0)
+			report.first_bad_line = lines;
+	};
+
+	const char* p = begin;
+	while (p < end)
+	{
+		const char* line_end = (const char*)memchr(p, '\n', end - p);
+		if (line_end == nullptr)
+			line_end = end;
+
+		const char* q = p;
+		p = line_end + 1;
+		lines++;
+
+		while (q < line_end && (*q == ' ' || *q == '\t'))
+			q++;
+		if (q == line_end || *q == '\r')
+			continue;
+
+		if (format == FORMAT_DIMACS)
+		{
+			// only arc lines hold edges
+			if (*q != 'a')
+				continue;
+			q++;
+		}
+		else if (*q == '#' || *q == '%')
+			continue;
+
+		size_t u, v, weight = 1;
+		bool kept = true;
+		if (!import_readNumber(q, line_end, u) || !import_readNumber(q, line_end, v) || u < base || v < base
+			|| u - base >= limit || v - base >= limit)
+		{
+			badLine();
+			continue;
+		}
+		if (!import_lineEnds(q, line_end))
+		{
+			// a weight, and nothing after it
+			if (!import_readWeight(q, line_end, weight, kept) || !import_lineEnds(q, line_end))
+			{
+				badLine();
+				continue;
+			}
+			weighted = true;
+		}
+		if (!kept)
+		{
+			report.bad_weights++;
+			continue;
+		}
+
+		u -= base;
+		v -= base;
+		if (u == v)
+		{
+			report.self_loops++;
+			continue;
+		}
+
+		max_vertex = std::max(max_vertex, std::max(u, v));
+		edges.emplace_back(u, v, weight);
+	}
+}
+
+// reads the header of a Matrix Market or DIMACS file, returns the offset of the first edge line (0 for an edge list)
+// or SIZE_MAX if the header can't be read
+inline size_t import_readHeader(const char* data, size_t length, GraphFileFormat format, ImportedGraph& graph)
+{
+	const char* end = data + length;
+	const char* p = data;
+
+	auto nextLine = [&](const char* line)
+	{
+		const char* line_end = (const char*)memchr(line, '\n', end - line);
+		return (line_end == nullptr) ? end : line_end + 1;
+	};
+
+	if (format == FORMAT_MATRIX_MARKET)
+	{
+		// %%MatrixMarket matrix coordinate <field> <symmetry>
+		std::string banner(p, nextLine(p));
+		if (banner.compare(0, 14, "%%MatrixMarket") != 0 || banner.find("coordinate") == std::string::npos
+			|| banner.find("complex") != std::string::npos)
+			return SIZE_MAX;
+		graph.directed = (banner.find("symmetric") == std::string::npos && banner.find("hermitian") == std::string::npos);
+		graph.weighted = (banner.find("pattern") == std::string::npos);
+
+		// comments, then the "rows columns entries" line
+		for (p = nextLine(p); p < end && (*p == '%' || *p == '\n' || *p == '\r'); p = nextLine(p));
+		const char* line_end = nextLine(p);
+		size_t rows, columns, entries;
+		if (!import_readNumber(p, line_end, rows) || !import_readNumber(p, line_end, columns)
+			|| !import_readNumber(p, line_end, entries))
+			return SIZE_MAX;
+
+		graph.vertices = std::max(rows, columns);
+		graph.edges.reserve(entries);
+		return line_end - data;
+	}
+
+	if (format == FORMAT_DIMACS)
+	{
+		graph.directed = true;
+		graph.weighted = true;
+
+		// "p sp <vertices> <arcs>", anywhere before the arcs
+		for (; p < end; p = nextLine(p))
+			if (*p == 'p')
+			{
+				const char* line_end = nextLine(p);
+				const char* q = (const char*)memchr(p, 's', line_end - p);
+				size_t vertices, arcs;
+				if (q == nullptr || q + 2 > line_end || !import_readNumber(q += 2, line_end, vertices)
+					|| !import_readNumber(q, line_end, arcs))
+					return SIZE_MAX;
+
+				graph.vertices = vertices;
+				graph.edges.reserve(arcs);
+				return line_end - data;
+			}
+		return SIZE_MAX;
+	}
+
+	graph.vertices = 0;
+	return 0;
+}
+
+// renumbers the vertices of graph in increasing order of id, leaving out ids no edge uses,
+// for edge lists whose ids are spread far wider than their edges (e.g. 32-bit hashes), which would
+// otherwise make a vertex of every unused id in between
+// graph.report.original_id gets the old id of every vertex
+inline void import_compactIds(ImportedGraph& graph, ThreadPool& pool)
+{
+	std::vector<std::tuple<size_t, size_t, size_t>>& edges = graph.edges;
+	std::vector<size_t>& ids = graph.report.original_id;
+	ids.resize(2 * edges.size());
+	pool.parallelFor(0, edges.size(), 65536, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t e = lo; e < hi; e++)
+		{
+			ids[2 * e] = std::get<0>(edges[e]);
+			ids[2 * e + 1] = std::get<1>(edges[e]);
+		}
+	});
+
+	parallelSort(ids, std::less<size_t>(), pool);
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+	ids.shrink_to_fit();
+
+	pool.parallelFor(0, edges.size(), 65536, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t e = lo; e < hi; e++)
+		{
+			std::get<0>(edges[e]) = std::lower_bound(ids.begin(), ids.end(), std::get<0>(edges[e])) - ids.begin();
+			std::get<1>(edges[e]) = std::lower_bound(ids.begin(), ids.end(), std::get<1>(edges[e])) - ids.begin();
+		}
+	});
+	graph.vertices = ids.size();
+}
+
+// reads the graph in the text file at path, parsing chunks of it on all threads of pool
+// (the file is memory-mapped, and each chunk starts at the first line that begins inside it)
+// directed only matters for an edge list, the other formats say whether they are directed
+// (and how many vertices they have, so their edges can't name any other)
+// returns false if the file can't be read or its header is wrong (an empty file is an empty graph, whatever its format)
+inline bool importGraph(const std::string& path, GraphFileFormat format, bool directed, ThreadPool& pool,
+	ImportedGraph& graph)
+{
+	MappedFile file;
+	if (!file.open(path))
+		return false;
+
+	graph.directed = directed;
+	graph.weighted = false;
+	graph.report = ImportReport{};
+	graph.edges.clear();
+
+	if (file.length == 0)
+	{
+		graph.vertices = 0;
+		return true;
+	}
+
+	const char* data = (const char*)file.data;
+	size_t start = import_readHeader(data, file.length, format, graph);
+	if (start == SIZE_MAX)
+		return false;
+
+	size_t base = (format == FORMAT_EDGE_LIST) ? 0 : 1;
+	size_t limit = (format == FORMAT_EDGE_LIST) ? SIZE_MAX : graph.vertices;
+	size_t length = file.length - start;
+	size_t header_lines = std::count(data, data + start, '\n');
+	data += start;
+
+	// chunk c covers the lines that begin in [length * c / chunks, length * (c + 1) / chunks)
+	size_t chunks = std::max((size_t)1, std::min(pool.size() * IMPORT_CHUNKS_PER_THREAD, length / 4096));
+	std::vector<size_t> bounds(chunks + 1);
+	for (size_t c = 0; c <= chunks; c++)
+	{
+		size_t b = length * c / chunks;
+		if (b > 0 && b < length)
+		{
+			const char* line_end = (const char*)memchr(data + b - 1, '\n', length - b + 1);
+			b = (line_end == nullptr) ? length : line_end + 1 - data;
+		}
+		bounds[c] = b;
+	}
+
+	struct Chunk
+	{
+		std::vector<std::tuple<size_t, size_t, size_t>> edges;
+		ImportReport report;
+		size_t lines = 0;
+		size_t max_vertex = 0;
+		bool weighted = false;
+	};
+	std::vector<Chunk> parsed(chunks);
+
+	pool.parallelFor(0, chunks, 1, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t c = lo; c < hi; c++)
+			if (bounds[c] < bounds[c + 1])
+				import_parseChunk(data + bounds[c], data + bounds[c + 1], format, base, limit, parsed[c].edges,
+					parsed[c].report, parsed[c].lines, parsed[c].weighted, parsed[c].max_vertex);
+	});
+
+	// the chunks are put together in file order, each one copied by its own thread
+	std::vector<size_t> at(chunks + 1, 0);
+	for (size_t c = 0, line = header_lines; c < chunks; line += parsed[c].lines, c++)
+	{
+		at[c + 1] = at[c] + parsed[c].edges.size();
+		if (graph.report.bad_lines == 0 && parsed[c].report.bad_lines != 0)
+			graph.report.first_bad_line = line + parsed[c].report.first_bad_line;
+		graph.report.bad_lines += parsed[c].report.bad_lines;
+		graph.report.self_loops += parsed[c].report.self_loops;
+		graph.report.bad_weights += parsed[c].report.bad_weights;
+		if (!parsed[c].edges.empty())
+			graph.vertices = std::max(graph.vertices, parsed[c].max_vertex + 1);
+
+		// an edge list is weighted if any line has a weight (the other formats say so in their header)
+		if (format == FORMAT_EDGE_LIST)
+			graph.weighted = graph.weighted || parsed[c].weighted;
+	}
+
+	graph.edges.resize(at[chunks]);
+	pool.parallelFor(0, chunks, 1, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t c = lo; c < hi; c++)
+		{
+			std::copy(parsed[c].edges.begin(), parsed[c].edges.end(), graph.edges.begin() + at[c]);
+			parsed[c].edges = std::vector<std::tuple<size_t, size_t, size_t>>();
+		}
+	});
+
+	// every id up to the largest one becomes a vertex, unless there are far more of them than the edges have ends
+	if (format == FORMAT_EDGE_LIST && graph.vertices > IMPORT_DENSE_IDS && graph.vertices > 2 * graph.edges.size())
+		import_compactIds(graph, pool);
+
+	return true;
+}
+
+#endif
@@ -4,13 +4,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include "Pool.h"
+#include <memory>
+#include <unordered_map>
+
+// a list gets a hash index from this many nodes on, shorter lists are searched by walking them
+const size_t LIST_INDEX_THRESHOLD = 32;
 
 // single node of adjacency list of ith node
 class ListNode
 {
 public:
-	int data;
-
 	// weight of path from ith node to this node
 	// (default weight = 1)
 	size_t weight;
@@ -20,12 +24,16 @@ public:
 
 	ListNode* next;
 
+	// previous node in the list, so a node can be unlinked without walking the list
+	ListNode* prev;
+
 	// ListNode constructor with optional weight (from ith node to this node)
 	// default weight = 1
 	ListNode(size_t _index, size_t _weight = 1)
 	{
 		index = _index;
 		next = nullptr;
+		prev = nullptr;
 		weight = _weight;
 	}
 	
@@ -36,16 +44,33 @@ class List
 {
 public:
 	ListNode* head;
+
+	// last node of the list, so insert() can append without walking the list
+	ListNode* tail;
+
 	size_t list_index;
 	size_t list_size;
 
+	// neighbouring lists in the AdjList's chain (prev lets a list be taken out of the chain without walking it)
 	List* next;
+	List* prev;
+
+	// pool that the nodes of this list are allocated from (owned by the AdjList)
+	Pool<ListNode>* node_pool;
 
-	// List constructor (need to provide index (vertex number))
-	List(size_t _index)
+	// nodes by the vertex they lead to, only made once the list reaches LIST_INDEX_THRESHOLD nodes
+	// (a multimap, since there can be parallel edges)
+	std::unique_ptr<std::unordered_multimap<size_t, ListNode*>> node_index;
+
+	// List constructor (need to provide index (vertex number) and the pool to allocate nodes from)
+	List(size_t _index, Pool<ListNode>* _node_pool)
 	{
+		node_pool = _node_pool;
+
 		head = nullptr;
+		tail = nullptr;
 		next = nullptr;
+		prev = nullptr;
 
 		list_size = 0;
 		list_index = _index;
@@ -54,82 +79,86 @@ public:
 	// returns whether list is empty
 	bool isEmpty() { return (head == nullptr); }
 
-	// searches for a vertex number in the list
+	// searches for a vertex number in the list (through the index if the list has one)
 	// returns pointer to node if found, else returns nullptr
 	ListNode* find(size_t index)
 	{
-		if(isEmpty())
-			return nullptr;
-
-		ListNode* ptr = head;
-		while(ptr != nullptr)
+		if (node_index)
 		{
+			std::unordered_multimap<size_t, ListNode*>::iterator it = node_index->find(index);
+			return (it == node_index->end()) ? nullptr : it->second;
+		}
+
+		for (ListNode* ptr = head; ptr != nullptr; ptr = ptr->next)
 			if (ptr->index == index)
 				return ptr;
-
-			ptr = ptr->next;
-		}
 		return nullptr;
 	}
 
-	// insert into list, increment list size (default weight = 1)
+	// insert at the end of the list, increment list size (default weight = 1)
 	bool insert(size_t idx, size_t _weight = 1)
 	{
+		ListNode* node = node_pool->create(idx, _weight);
 		if (isEmpty())
+			head = node;
+		else
 		{
-			head = new ListNode(idx, _weight); //;_init(idx);
-			list_size++;
+			tail->next = node;
+			node->prev = tail;
+		}
+		tail = node;
+		list_size++;
 
-			return true;
+		if (node_index)
+			node_index->emplace(idx, node);
+		else if (list_size == LIST_INDEX_THRESHOLD)
+		{
+			node_index.reset(new std::unordered_multimap<size_t, ListNode*>());
+			node_index->reserve(2 * LIST_INDEX_THRESHOLD);
+			for (ListNode* ptr = head; ptr != nullptr; ptr = ptr->next)
+				node_index->emplace(ptr->index, ptr);
 		}
+		return true;
+	}
 
-		ListNode* ptr = head;
+	// unlinks a node of this list and frees it, decrement list size
+	void unlink(ListNode* node)
+	{
+		if (node_index)
+		{
+			std::pair<std::unordered_multimap<size_t, ListNode*>::iterator,
+				std::unordered_multimap<size_t, ListNode*>::iterator> range = node_index->equal_range(node->index);
+			for (std::unordered_multimap<size_t, ListNode*>::iterator it = range.first; it != range.second; ++it)
+				if (it->second == node)
+				{
+					node_index->erase(it);
+					break;
+				}
+		}
 
-		while (ptr->next != nullptr)// && ptr->index < )
-			ptr = ptr->next;
-		
-		ptr->next = new ListNode(idx, _weight);
+		if (node->prev == nullptr)
+			head = node->next;
+		else
+			node->prev->next = node->next;
+		if (node->next == nullptr)
+			tail = node->prev;
+		else
+			node->next->prev = node->prev;
 
-		list_size++;
-		return true;
+		node_pool->destroy(node);
+		list_size--;
 	}
 
 	// calls find and searches for a vertex (whose index is the index passed)
 	// if found, remove vertex from list and decrement list size
 	bool remove(size_t idx)
 	{
-		if (find(idx) == nullptr)
+		ListNode* node = find(idx);
+		if (node == nullptr)
 			return false;
-		
-		if (head->index == idx)
-		{
-			ListNode* temp = head;
-			head = head->next;
-			delete(temp);
-
-			list_size--;
-			return true;
-		}
-
-		ListNode* ptr = head;
 
-		ListNode* prevptr = nullptr;
-		while (ptr != nullptr)
-		{
-			if (ptr->index == idx && prevptr)
-			{
-				ListNode* temp = ptr;
-				prevptr->next = ptr->next;
-				delete(temp);
-
-				list_size--;
-				return true;
-			}
-			prevptr = ptr;
-			ptr = ptr->next;
-		}
-
-		return false;
+		unlink(node);
+		return true;
 	}
 
 	// pop from front of list
@@ -138,11 +167,7 @@ public:
 		if(isEmpty())
 			return false;
 		
-		ListNode* temp = head;
-		head = head->next;
-		delete(temp);
-
-		list_size--;
+		unlink(head);
 		return true;
 	}
 
@@ -0,0 +1,196 @@
+#ifndef MST_H
+#define MST_H
+
+#include "CSR.h"
+#include "Heap.h"
+#include "ShortestPaths.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// edge (u, v) of a spanning tree, u is the vertex v was connected from
+struct MSTEdge
+{
+	size_t u;
+	size_t v;
+	size_t weight;
+};
+
+// "no edge" entry of the per-component cheapest edge array in boruvka()
+const size_t NO_EDGE = SIZE_MAX;
+
+// minimum spanning tree (or forest) as a list of edges
+struct SpanningTree
+{
+	std::vector<MSTEdge> edges;
+	size_t total_weight;
+};
+
+// Prim's algorithm from root with an indexed heap, O(E log V)
+// returns the minimum spanning tree of the component that contains root,
+// with the edges ordered by the vertex they lead to
+inline SpanningTree prim(const CSR& g, size_t root)
+{
+	size_t n = g.size();
+
+	// cheapest known edge into every vertex not yet in the tree
+	std::vector<size_t> key(n, UNREACHABLE);
+	std::vector<size_t> parent(n, NO_PARENT);
+	std::vector<bool> included(n, false);
+
+	IndexedHeap heap(n);
+	key[root] = 0;
+	heap.pushOrDecrease(root, 0);
+
+	while (!heap.empty())
+	{
+		size_t u = heap.pop();
+		included[u] = true;
+
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			size_t v = g.targets[e];
+			if (!included[v] && g.weights[e] < key[v])
+			{
+				key[v] = g.weights[e];
+				parent[v] = u;
+				heap.pushOrDecrease(v, key[v]);
+			}
+		}
+	}
+
+	SpanningTree mst;
+	mst.total_weight = 0;
+	for (size_t v = 0; v < n; v++)
+		if (parent[v] != NO_PARENT)
+		{
+			mst.edges.push_back(MSTEdge{parent[v], v, key[v]});
+			mst.total_weight += key[v];
+		}
+
+	return mst;
+}
+
+// every edge of an undirected graph once (the CSR stores it in both directions), as (u < v, weight)
+inline std::vector<MSTEdge> undirectedEdges(const CSR& g)
+{
+	std::vector<MSTEdge> edge_list;
+	edge_list.reserve(g.edgeCount() / 2);
+
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			if (u < g.targets[e])
+				edge_list.push_back(MSTEdge{u, g.targets[e], g.weights[e]});
+
+	return edge_list;
+}
+
+// Kruskal's algorithm: takes the edges from lightest to heaviest, keeping those that join two different trees
+// sorts the edges on the threads of pool if one is given
+// returns a minimum spanning forest (one tree per connected component), edges in the order they were picked
+inline SpanningTree kruskal(const CSR& g, ThreadPool* pool = nullptr)
+{
+	std::vector<MSTEdge> edge_list = undirectedEdges(g);
+
+	auto lighter = [](const MSTEdge& a, const MSTEdge& b) { return a.weight < b.weight; };
+	if (pool)
+		parallelSort(edge_list, lighter, *pool);
+	else
+		std::sort(edge_list.begin(), edge_list.end(), lighter);
+
+	SpanningTree mst;
+	mst.total_weight = 0;
+
+	UnionFind trees(g.size());
+	for (const MSTEdge& edge : edge_list)
+		if (trees.unite(edge.u, edge.v))
+		{
+			mst.edges.push_back(edge);
+			mst.total_weight += edge.weight;
+		}
+
+	return mst;
+}
+
+// Borůvka's algorithm: every round, each tree picks the cheapest edge leaving it, and all of them are added at once,
+// so the number of trees at least halves every round
+// the per-round scan of the edges runs on the threads of pool, each tree's cheapest edge kept with a compare-and-swap
+// returns a minimum spanning forest (one tree per connected component)
+inline SpanningTree boruvka(const CSR& g, ThreadPool& pool)
+{
+	std::vector<MSTEdge> edge_list = undirectedEdges(g);
+	size_t n = g.size();
+	size_t m = edge_list.size();
+
+	SpanningTree mst;
+	mst.total_weight = 0;
+
+	UnionFind trees(n);
+
+	// tree (root in trees) of every vertex, refreshed after every round
+	std::vector<size_t> tree(n);
+	for (size_t v = 0; v < n; v++)
+		tree[v] = v;
+
+	// cheapest edge leaving every tree, by index in edge_list
+	std::vector<size_t> cheapest(n);
+
+	// ties are broken by edge index, so all trees agree on one order and no cycle can form
+	auto lighter = [&](size_t a, size_t b)
+	{
+		return edge_list[a].weight < edge_list[b].weight || (edge_list[a].weight == edge_list[b].weight && a < b);
+	};
+
+	while (true)
+	{
+		std::fill(cheapest.begin(), cheapest.end(), NO_EDGE);
+
+		pool.parallelFor(0, m, 4096, [&](size_t lo, size_t hi, size_t)
+		{
+			for (size_t e = lo; e < hi; e++)
+			{
+				size_t tu = tree[edge_list[e].u], tv = tree[edge_list[e].v];
+				if (tu == tv)
+					continue;
+
+				for (size_t t : {tu, tv})
+				{
+					std::atomic_ref<size_t> best(cheapest[t]);
+					size_t current = best.load(std::memory_order_relaxed);
+					while ((current == NO_EDGE || lighter(e, current))
+						&& !best.compare_exchange_weak(current, e, std::memory_order_relaxed));
+				}
+			}
+		});
+
+		// two trees may pick the same edge, unite() only lets it in once
+		bool merged = false;
+		for (size_t t = 0; t < n; t++)
+			if (cheapest[t] != NO_EDGE)
+			{
+				const MSTEdge& edge = edge_list[cheapest[t]];
+				if (trees.unite(edge.u, edge.v))
+				{
+					mst.edges.push_back(edge);
+					mst.total_weight += edge.weight;
+					merged = true;
+				}
+			}
+
+		if (!merged)
+			break;
+
+		pool.parallelFor(0, n, 4096, [&](size_t lo, size_t hi, size_t)
+		{
+			for (size_t v = lo; v < hi; v++)
+				tree[v] = trees.findRoot(v);
+		});
+	}
+
+	return mst;
+}
+
+#endif
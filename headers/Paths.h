@@ -0,0 +1,259 @@
+#ifndef PATHS_H
+#define PATHS_H
+
+#include "CSR.h"
+#include "DFS.h"
+#include "Heap.h"
+#include "ShortestPaths.h"
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <utility>
+#include <vector>
+
+// limits on an enumeration of paths, 0 means no limit
+struct PathLimits
+{
+	// longest path to report, in edges
+	size_t max_edges = 0;
+
+	// number of paths after which to stop
+	size_t max_paths = 0;
+
+	// seconds after which to stop
+	double time_budget = 0;
+};
+
+// why an enumeration of paths ended
+// PATHS_ALL = every path was reported, PATHS_MAX_PATHS / PATHS_TIME_BUDGET = a limit was hit,
+// PATHS_STOPPED = the callback asked to stop
+enum PathsEnd {PATHS_ALL, PATHS_MAX_PATHS, PATHS_TIME_BUDGET, PATHS_STOPPED};
+
+// the clock is only read every this many vertices, reading it is slower than stepping the search
+const size_t PATHS_CLOCK_INTERVAL = 1024;
+
+// calls emit(path) for every simple path from source to target (path = its vertices, source first),
+// one at a time as the depth-first search finds them, without keeping any of them
+// emit returns true to stop the enumeration
+// in = the graph with its edges reversed, used to skip every vertex from which target can't be reached
+template <class Emit>
+PathsEnd enumeratePaths(const CSR& g, const CSR& in, size_t source, size_t target, const PathLimits& limits, Emit&& emit)
+{
+	if (!g.exists(source) || !g.exists(target))
+		return PATHS_ALL;
+
+	// vertices target can be reached from
+	std::vector<bool> useful(g.size(), false);
+	std::vector<size_t> queue(1, target);
+	useful[target] = true;
+	for (size_t i = 0; i < queue.size(); i++)
+		for (size_t e = in.edgeBegin(queue[i]); e < in.edgeEnd(queue[i]); e++)
+			if (!useful[in.targets[e]])
+			{
+				useful[in.targets[e]] = true;
+				queue.push_back(in.targets[e]);
+			}
+
+	if (!useful[source])
+		return PATHS_ALL;
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+		std::chrono::duration<double>(limits.time_budget));
+
+	// parallel edges would report the same paths again, only the first edge from u to each v is followed
+	std::vector<bool> first_edge(g.edgeCount(), false);
+	std::vector<size_t> seen_from(g.size(), SIZE_MAX);
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			if (seen_from[g.targets[e]] != u)
+			{
+				seen_from[g.targets[e]] = u;
+				first_edge[e] = true;
+			}
+
+	std::vector<size_t> path;
+	size_t found = 0, steps = 0;
+	PathsEnd end = PATHS_ALL;
+
+	DFS dfs(g);
+
+	auto pre = [&](size_t x)
+	{
+		if (limits.time_budget > 0 && ++steps % PATHS_CLOCK_INTERVAL == 0 && Clock::now() > deadline)
+		{
+			end = PATHS_TIME_BUDGET;
+			return DFS_STOP;
+		}
+
+		// the edge x was reached through is the one just taken by the vertex on top of the stack
+		path.push_back(x);
+		if (!dfs.stack.empty() && !first_edge[dfs.stack.back().cursor.edge - 1])
+			return DFS_SKIP_CHILDREN;
+
+		if (x != target)
+		{
+			// going further would make the path too long, or can't lead to target
+			if (!useful[x] || (limits.max_edges > 0 && path.size() > limits.max_edges))
+				return DFS_SKIP_CHILDREN;
+			return DFS_CONTINUE;
+		}
+
+		if (emit(path))
+		{
+			end = PATHS_STOPPED;
+			return DFS_STOP;
+		}
+		if (limits.max_paths > 0 && ++found == limits.max_paths)
+		{
+			end = PATHS_MAX_PATHS;
+			return DFS_STOP;
+		}
+		return DFS_SKIP_CHILDREN;
+	};
+
+	// a vertex is taken off the path when the search backs out of it, and set back to WHITE
+	// so it can be part of other paths
+	auto post = [&](size_t x)
+	{
+		path.pop_back();
+		dfs.colour[x] = WHITE;
+		return false;
+	};
+
+	dfs.run(source, pre, post, DFSNoHook());
+	return end;
+}
+
+// a path as its vertices (source first) and the sum of its edge weights
+struct WeightedPath
+{
+	std::vector<size_t> vertices;
+	size_t length;
+
+	bool operator<(const WeightedPath& other) const
+	{
+		return length < other.length || (length == other.length && vertices < other.vertices);
+	}
+};
+
+// weight of the lightest edge (u, v), UNREACHABLE if there is none
+inline size_t paths_edgeWeight(const CSR& g, size_t u, size_t v)
+{
+	size_t weight = UNREACHABLE;
+	for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		if (g.targets[e] == v && g.weights[e] < weight)
+			weight = g.weights[e];
+	return weight;
+}
+
+// shortest path from source to target that avoids the vertices with banned_vertex set
+// and the edges (source, v) with banned_next[v] set, an empty path if there is none
+inline WeightedPath paths_restrictedDijkstra(const CSR& g, size_t source, size_t target,
+	const std::vector<bool>& banned_vertex, const std::vector<bool>& banned_next)
+{
+	std::vector<size_t> dist(g.size(), UNREACHABLE), parent(g.size(), NO_PARENT);
+	IndexedHeap heap(g.size());
+	dist[source] = 0;
+	heap.pushOrDecrease(source, 0);
+
+	while (!heap.empty())
+	{
+		size_t d = heap.topKey();
+		size_t u = heap.pop();
+		if (u == target)
+			break;
+
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			size_t v = g.targets[e];
+			if (banned_vertex[v] || (u == source && banned_next[v]))
+				continue;
+
+			size_t nd = d + g.weights[e];
+			if (nd < dist[v])
+			{
+				dist[v] = nd;
+				parent[v] = u;
+				heap.pushOrDecrease(v, nd);
+			}
+		}
+	}
+
+	WeightedPath path;
+	path.length = dist[target];
+	if (dist[target] == UNREACHABLE)
+		return path;
+
+	for (size_t v = target; v != NO_PARENT; v = parent[v])
+		path.vertices.push_back(v);
+	std::reverse(path.vertices.begin(), path.vertices.end());
+	return path;
+}
+
+// Yen's algorithm: the k shortest simple paths from source to target, shortest first (fewer if there aren't k)
+// every next path leaves one of the paths already found at some vertex (the spur), and takes the shortest way
+// from there that doesn't reuse an edge leaving the spur that a path with the same start already took
+inline std::vector<WeightedPath> yenKShortestPaths(const CSR& g, size_t source, size_t target, size_t k)
+{
+	std::vector<WeightedPath> shortest;
+	if (k == 0 || !g.exists(source) || !g.exists(target))
+		return shortest;
+
+	std::vector<bool> banned_vertex(g.size(), false), banned_next(g.size(), false);
+
+	WeightedPath first = paths_restrictedDijkstra(g, source, target, banned_vertex, banned_next);
+	if (first.vertices.empty())
+		return shortest;
+	shortest.push_back(first);
+
+	// candidates for the next path, ordered by length (a set also drops the ones found twice)
+	std::set<WeightedPath> candidates;
+
+	while (shortest.size() < k)
+	{
+		const std::vector<size_t> last = shortest.back().vertices;
+		size_t root_length = 0;
+
+		for (size_t i = 0; i + 1 < last.size(); i++)
+		{
+			size_t spur = last[i];
+
+			// edges out of the spur already taken by a found path that starts like this one
+			for (const WeightedPath& p : shortest)
+				if (p.vertices.size() > i + 1 && std::equal(last.begin(), last.begin() + i + 1, p.vertices.begin()))
+					banned_next[p.vertices[i + 1]] = true;
+
+			WeightedPath spur_path = paths_restrictedDijkstra(g, spur, target, banned_vertex, banned_next);
+			if (!spur_path.vertices.empty())
+			{
+				WeightedPath candidate;
+				candidate.vertices.assign(last.begin(), last.begin() + i);
+				candidate.vertices.insert(candidate.vertices.end(), spur_path.vertices.begin(), spur_path.vertices.end());
+				candidate.length = root_length + spur_path.length;
+				candidates.insert(candidate);
+			}
+
+			for (const WeightedPath& p : shortest)
+				if (p.vertices.size() > i + 1)
+					banned_next[p.vertices[i + 1]] = false;
+
+			// the spur is part of the root from now on
+			banned_vertex[spur] = true;
+			root_length += paths_edgeWeight(g, spur, last[i + 1]);
+		}
+
+		for (size_t v : last)
+			banned_vertex[v] = false;
+
+		if (candidates.empty())
+			break;
+		shortest.push_back(*candidates.begin());
+		candidates.erase(candidates.begin());
+	}
+
+	return shortest;
+}
+
+#endif
@@ -0,0 +1,122 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdlib.h>
+#include <new>
+#include <utility>
+#include <vector>
+
+// slab allocator for objects of one type
+// objects are carved out of large slabs, freed objects go onto a free list and are reused
+// by later create() calls, and all slabs are released together when the pool is destroyed
+template <class T>
+class Pool
+{
+	// a slot either holds a live object or links to the next free slot
+	union Slot
+	{
+		Slot* next_free;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	// all slabs allocated so far
+	std::vector<Slot*> slabs;
+
+	// number of slots in each new slab (unless reserve() asks for more)
+	size_t slab_size;
+
+	// unused part of the newest slab
+	Slot* cursor;
+	Slot* cursor_end;
+
+	// slots returned by destroy()
+	Slot* free_list;
+	size_t free_count;
+
+	// allocates a new slab of n slots, first moving the unused part of the old slab to the free list
+	void newSlab(size_t n)
+	{
+		while (cursor != cursor_end)
+		{
+			cursor->next_free = free_list;
+			free_list = cursor++;
+			free_count++;
+		}
+
+		Slot* slab = (Slot*)malloc(n * sizeof(Slot));
+		if (slab == nullptr)
+			throw std::bad_alloc();
+
+		slabs.push_back(slab);
+		cursor = slab;
+		cursor_end = slab + n;
+	}
+
+public:
+	Pool(size_t _slab_size = 1024)
+	{
+		slab_size = _slab_size;
+		cursor = cursor_end = nullptr;
+		free_list = nullptr;
+		free_count = 0;
+	}
+
+	~Pool() { release(); }
+
+	Pool(const Pool&) = delete;
+	Pool& operator=(const Pool&) = delete;
+
+	// constructs an object in a free slot, allocating a new slab only if there is none
+	template <class... Args>
+	T* create(Args&&... args)
+	{
+		Slot* slot;
+		if (free_list != nullptr)
+		{
+			slot = free_list;
+			free_list = free_list->next_free;
+			free_count--;
+		}
+		else
+		{
+			if (cursor == cursor_end)
+				newSlab(slab_size);
+			slot = cursor++;
+		}
+
+		return new (slot->storage) T(std::forward<Args>(args)...);
+	}
+
+	// destroys an object made by create() and puts its slot on the free list
+	void destroy(T* obj)
+	{
+		obj->~T();
+
+		Slot* slot = (Slot*)obj;
+		slot->next_free = free_list;
+		free_list = slot;
+		free_count++;
+	}
+
+	// makes sure the next n calls to create() don't need to allocate
+	void reserve(size_t n)
+	{
+		size_t available = free_count + (cursor_end - cursor);
+		if (available < n)
+			newSlab(n - available > slab_size ? n - available : slab_size);
+	}
+
+	// frees every slab at once, without running destructors of objects still alive in them
+	void release()
+	{
+		for (Slot* slab : slabs)
+			free(slab);
+
+		slabs.clear();
+		cursor = cursor_end = nullptr;
+		free_list = nullptr;
+		free_count = 0;
+	}
+};
+
+#endif
@@ -0,0 +1,171 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "CSR.h"
+#include <stdint.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+// ways of renumbering vertices so that the ones visited together sit close together in memory
+// ORDER_RCM    = reverse Cuthill-McKee: breadth-first from a vertex at the edge of the graph, lower degrees first,
+//                then reversed, which keeps the neighbours of every vertex within a narrow band of indices
+// ORDER_DEGREE = highest degree first, so the most visited vertices share the fewest cache lines
+enum VertexOrdering {ORDER_RCM, ORDER_DEGREE};
+
+// number of edges of u in either direction (in = g reversed, or g itself if it is undirected)
+inline size_t reorder_degree(const CSR& g, const CSR& in, size_t u)
+{
+	return (&in == &g) ? g.degree(u) : g.degree(u) + in.degree(u);
+}
+
+// calls fn(v) for every edge of u in either direction
+template <class Fn>
+void reorder_forEachNeighbour(const CSR& g, const CSR& in, size_t u, Fn&& fn)
+{
+	for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		fn(g.targets[e]);
+	if (&in != &g)
+		for (size_t e = in.edgeBegin(u); e < in.edgeEnd(u); e++)
+			fn(in.targets[e]);
+}
+
+// reverse Cuthill-McKee order of the vertices of g, edges taken as undirected
+// returns the existing vertices in their new order (so result[i] is the vertex that becomes i)
+// every component starts at a pseudo-peripheral vertex: the search starts at its lowest degree vertex and moves
+// to the lowest degree vertex of the farthest level for as long as that makes the levels deeper
+inline std::vector<size_t> reverseCuthillMcKee(const CSR& g, const CSR& in)
+{
+	size_t n = g.size();
+	std::vector<size_t> degree(n, 0), by_degree;
+	for (size_t u = 0; u < n; u++)
+		if (g.exists(u))
+		{
+			degree[u] = reorder_degree(g, in, u);
+			by_degree.push_back(u);
+		}
+	auto lower_degree = [&](size_t a, size_t b) { return degree[a] < degree[b]; };
+	std::stable_sort(by_degree.begin(), by_degree.end(), lower_degree);
+
+	std::vector<size_t> order, queue, neighbours;
+	order.reserve(by_degree.size());
+	std::vector<bool> placed(n, false);
+
+	// stamp[v] == pass for vertices reached by the current level search, so it never has to be cleared
+	std::vector<size_t> stamp(n, 0);
+	size_t pass = 0;
+
+	// breadth-first search from s over the unplaced vertices, queue gets them level by level
+	// returns the number of levels after the first, last_level gets the position in queue where the last one starts
+	auto levels = [&](size_t s, size_t& last_level)
+	{
+		pass++;
+		queue.assign(1, s);
+		stamp[s] = pass;
+
+		for (size_t depth = 0, begin = 0; ; depth++)
+		{
+			size_t end = queue.size();
+			for (size_t i = begin; i < end; i++)
+				reorder_forEachNeighbour(g, in, queue[i], [&](size_t v)
+				{
+					if (!placed[v] && stamp[v] != pass)
+					{
+						stamp[v] = pass;
+						queue.push_back(v);
+					}
+				});
+
+			if (queue.size() == end)
+			{
+				last_level = begin;
+				return depth;
+			}
+			begin = end;
+		}
+	};
+
+	for (size_t start : by_degree)
+	{
+		if (placed[start])
+			continue;
+
+		size_t last_level;
+		size_t depth = levels(start, last_level);
+		while (true)
+		{
+			size_t candidate = *std::min_element(queue.begin() + last_level, queue.end(), lower_degree);
+			size_t candidate_last;
+			size_t candidate_depth = levels(candidate, candidate_last);
+			if (candidate_depth <= depth)
+				break;
+			start = candidate;
+			depth = candidate_depth;
+			last_level = candidate_last;
+		}
+
+		// Cuthill-McKee: breadth-first, the unplaced neighbours of every vertex taken lowest degree first
+		size_t i = order.size();
+		order.push_back(start);
+		placed[start] = true;
+		for (; i < order.size(); i++)
+		{
+			neighbours.clear();
+			reorder_forEachNeighbour(g, in, order[i], [&](size_t v)
+			{
+				if (!placed[v])
+				{
+					placed[v] = true;
+					neighbours.push_back(v);
+				}
+			});
+
+			std::stable_sort(neighbours.begin(), neighbours.end(), lower_degree);
+			order.insert(order.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+
+	std::reverse(order.begin(), order.end());
+	return order;
+}
+
+// the existing vertices of g from highest to lowest degree (in both directions), ties kept in index order
+inline std::vector<size_t> degreeOrder(const CSR& g, const CSR& in)
+{
+	std::vector<size_t> order, degree(g.size(), 0);
+	for (size_t u = 0; u < g.size(); u++)
+		if (g.exists(u))
+		{
+			degree[u] = reorder_degree(g, in, u);
+			order.push_back(u);
+		}
+
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return degree[a] > degree[b]; });
+	return order;
+}
+
+// the edges of g with every vertex renumbered, order[i] being the vertex that becomes i
+// (an undirected edge is given once, as g stores it twice)
+inline std::vector<std::tuple<size_t, size_t, size_t>> relabelledEdges(const CSR& g, const std::vector<size_t>& order,
+	bool directed)
+{
+	std::vector<size_t> new_id(g.size(), SIZE_MAX);
+	for (size_t i = 0; i < order.size(); i++)
+		new_id[order[i]] = i;
+
+	std::vector<std::tuple<size_t, size_t, size_t>> edges;
+	edges.reserve(directed ? g.edgeCount() : g.edgeCount() / 2);
+	for (size_t u = 0; u < order.size(); u++)
+	{
+		size_t old = order[u];
+		for (size_t e = g.edgeBegin(old); e < g.edgeEnd(old); e++)
+		{
+			size_t v = new_id[g.targets[e]];
+			if (directed || u < v)
+				edges.emplace_back(u, v, g.weights[e]);
+		}
+	}
+	return edges;
+}
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef SCC_H
+#define SCC_H
+
+#include "CSR.h"
+#include "Components.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+// Tarjan's strongly connected components, with an explicit stack instead of recursion, O(V + E)
+// components are numbered in order of their lowest vertex, like connectedComponents()
+inline Components tarjanSCC(const CSR& g)
+{
+	const size_t UNVISITED = SIZE_MAX;
+	size_t n = g.size();
+
+	// order in which the search reached each vertex, and the lowest order reachable from its subtree
+	// through edges to vertices that are still on the component stack
+	std::vector<size_t> order(n, UNVISITED);
+	std::vector<size_t> low(n);
+
+	// vertices reached but not yet assigned to a component
+	std::vector<size_t> component_stack;
+	std::vector<bool> on_stack(n, false);
+
+	// the vertex every vertex's component was closed at
+	std::vector<size_t> label(n, NO_COMPONENT);
+
+	struct Frame
+	{
+		size_t vertex;
+		size_t edge;
+	};
+	std::vector<Frame> call_stack;
+	size_t counter = 0;
+
+	auto reach = [&](size_t v)
+	{
+		order[v] = low[v] = counter++;
+		component_stack.push_back(v);
+		on_stack[v] = true;
+		call_stack.push_back(Frame{v, g.edgeBegin(v)});
+	};
+
+	for (size_t root = 0; root < n; root++)
+	{
+		if (!g.exists(root) || order[root] != UNVISITED)
+			continue;
+
+		reach(root);
+		while (!call_stack.empty())
+		{
+			Frame& top = call_stack.back();
+			size_t u = top.vertex;
+
+			if (top.edge < g.edgeEnd(u))
+			{
+				size_t v = g.targets[top.edge++];
+				if (order[v] == UNVISITED)
+					reach(v);
+				else if (on_stack[v])
+					low[u] = std::min(low[u], order[v]);
+				continue;
+			}
+
+			// all edges of u done, hand its low value up to the vertex it was reached from
+			call_stack.pop_back();
+			if (!call_stack.empty())
+			{
+				size_t parent = call_stack.back().vertex;
+				low[parent] = std::min(low[parent], low[u]);
+			}
+
+			// u is the first vertex of its component that was reached, everything above it on the stack belongs to it
+			if (low[u] == order[u])
+			{
+				size_t w;
+				do
+				{
+					w = component_stack.back();
+					component_stack.pop_back();
+					on_stack[w] = false;
+					label[w] = u;
+				} while (w != u);
+			}
+		}
+	}
+
+	return components_fromLabels(g, label);
+}
+
+// marks (seen[v] = pass) every vertex v with part[v] == p that can be reached from pivot without leaving part p,
+// expanding each level of the search on all threads of pool
+inline void scc_reach(const CSR& g, size_t pivot, const std::vector<size_t>& part, size_t p,
+	std::vector<size_t>& seen, size_t pass, ThreadPool& pool)
+{
+	seen[pivot] = pass;
+	std::vector<size_t> frontier(1, pivot), next;
+	std::vector<std::vector<size_t>> found(pool.size());
+
+	while (!frontier.empty())
+	{
+		pool.parallelFor(0, frontier.size(), 64, [&](size_t lo, size_t hi, size_t thread_id)
+		{
+			for (size_t i = lo; i < hi; i++)
+			{
+				size_t u = frontier[i];
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				{
+					size_t v = g.targets[e];
+					if (part[v] != p)
+						continue;
+
+					std::atomic_ref<size_t> seen_v(seen[v]);
+					size_t old = seen_v.load(std::memory_order_relaxed);
+					if (old != pass && seen_v.compare_exchange_strong(old, pass, std::memory_order_relaxed))
+						found[thread_id].push_back(v);
+				}
+			}
+		});
+
+		next.clear();
+		for (std::vector<size_t>& mine : found)
+		{
+			next.insert(next.end(), mine.begin(), mine.end());
+			mine.clear();
+		}
+		std::swap(frontier, next);
+	}
+}
+
+// strongly connected components with the forward-backward (FW-BW) algorithm
+// in = the graph with its edges reversed
+// vertices without in-edges or without out-edges are trimmed off as components of their own first (repeatedly),
+// then the rest is split up: the vertices both reachable from a pivot and reaching it form the pivot's component,
+// and those reached only forwards, only backwards, or not at all are three sets no component can span,
+// each split up the same way in turn
+// the searches run on all threads of pool, the components come out numbered like tarjanSCC()'s
+inline Components parallelSCC(const CSR& g, const CSR& in, ThreadPool& pool)
+{
+	const size_t DONE = SIZE_MAX;
+	size_t n = g.size();
+
+	std::vector<size_t> label(n, NO_COMPONENT);
+
+	// set each vertex still belongs to (DONE once it has its component)
+	std::vector<size_t> part(n, 0);
+
+	// trimming: count the edges every vertex has to and from vertices that aren't trimmed yet
+	std::vector<size_t> in_degree(n), out_degree(n);
+	pool.parallelFor(0, n, 4096, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t v = lo; v < hi; v++)
+		{
+			in_degree[v] = in.degree(v);
+			out_degree[v] = g.degree(v);
+		}
+	});
+
+	std::vector<size_t> trimmed;
+	for (size_t v = 0; v < n; v++)
+		if (!g.exists(v))
+			part[v] = DONE;
+		else if (in_degree[v] == 0 || out_degree[v] == 0)
+		{
+			part[v] = DONE;
+			trimmed.push_back(v);
+		}
+
+	while (!trimmed.empty())
+	{
+		size_t v = trimmed.back();
+		trimmed.pop_back();
+		label[v] = v;
+
+		for (size_t e = g.edgeBegin(v); e < g.edgeEnd(v); e++)
+		{
+			size_t w = g.targets[e];
+			if (part[w] != DONE && --in_degree[w] == 0)
+			{
+				part[w] = DONE;
+				trimmed.push_back(w);
+			}
+		}
+		for (size_t e = in.edgeBegin(v); e < in.edgeEnd(v); e++)
+		{
+			size_t w = in.targets[e];
+			if (part[w] != DONE && --out_degree[w] == 0)
+			{
+				part[w] = DONE;
+				trimmed.push_back(w);
+			}
+		}
+	}
+
+	// sets still to split up, as (set number, its vertices)
+	std::vector<std::pair<size_t, std::vector<size_t>>> work;
+	std::vector<size_t> everything;
+	for (size_t v = 0; v < n; v++)
+		if (part[v] != DONE)
+			everything.push_back(v);
+	if (!everything.empty())
+		work.emplace_back(0, std::move(everything));
+
+	std::vector<size_t> forward(n, 0), backward(n, 0);
+	size_t sets = 1;
+
+	// every set is searched once, its number doubles as the mark of that search in forward[] and backward[]
+	while (!work.empty())
+	{
+		size_t p = work.back().first;
+		std::vector<size_t> vertices = std::move(work.back().second);
+		work.pop_back();
+
+		size_t pivot = vertices[0];
+		size_t pass = p + 1;
+		scc_reach(g, pivot, part, p, forward, pass, pool);
+		scc_reach(in, pivot, part, p, backward, pass, pool);
+
+		// forward only, backward only, neither
+		std::vector<size_t> rest[3];
+		for (size_t v : vertices)
+		{
+			bool f = (forward[v] == pass), b = (backward[v] == pass);
+			if (f && b)
+			{
+				label[v] = pivot;
+				part[v] = DONE;
+			}
+			else
+				rest[f ? 0 : (b ? 1 : 2)].push_back(v);
+		}
+
+		for (std::vector<size_t>& set : rest)
+			if (set.size() == 1)
+			{
+				label[set[0]] = set[0];
+				part[set[0]] = DONE;
+			}
+			else if (!set.empty())
+			{
+				for (size_t v : set)
+					part[v] = sets;
+				work.emplace_back(sets++, std::move(set));
+			}
+	}
+
+	return components_fromLabels(g, label);
+}
+
+// edges of the condensation of g: one vertex per strongly connected component in scc,
+// and an edge (a, b, weight) wherever some edge leads from component a to component b
+// (several such edges become one, with the smallest weight), the condensation is always acyclic
+inline std::vector<std::tuple<size_t, size_t, size_t>> condensationEdges(const CSR& g, const Components& scc)
+{
+	std::vector<std::tuple<size_t, size_t, size_t>> edge_list;
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			size_t a = scc.id[u], b = scc.id[g.targets[e]];
+			if (a != b)
+				edge_list.emplace_back(a, b, g.weights[e]);
+		}
+
+	// sorting puts the lightest edge between each pair of components first, unique() keeps that one
+	std::sort(edge_list.begin(), edge_list.end());
+	edge_list.erase(std::unique(edge_list.begin(), edge_list.end(), [](const auto& x, const auto& y)
+	{
+		return std::get<0>(x) == std::get<0>(y) && std::get<1>(x) == std::get<1>(y);
+	}), edge_list.end());
+
+	return edge_list;
+}
+
+#endif
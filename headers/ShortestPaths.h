@@ -0,0 +1,283 @@
+#ifndef SHORTEST_PATHS_H
+#define SHORTEST_PATHS_H
+
+#include "CSR.h"
+#include "Heap.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <limits.h>
+#include <algorithm>
+#include <vector>
+
+// distance of vertices that can't be reached from the source
+const size_t UNREACHABLE = SIZE_MAX;
+
+// parent of the source and of unreachable vertices
+const size_t NO_PARENT = SIZE_MAX;
+
+// "no path" entry of the all-pairs matrices (same value as INF in Graph.h)
+const size_t NO_PATH = INT_MAX;
+
+// side length of the square tiles the Floyd-Warshall matrices are processed in
+// (three 64 x 64 tiles of size_t fit in a typical L2 cache)
+const size_t FW_BLOCK = 64;
+
+// result of a single-source shortest path search
+// the shortest path to v is source -> ... -> parent[parent[v]] -> parent[v] -> v
+struct ShortestPaths
+{
+	size_t source;
+	std::vector<size_t> dist;
+	std::vector<size_t> parent;
+};
+
+// Dijkstra's algorithm with an indexed binary heap, each vertex is in the heap at most once
+inline void dijkstra_binaryHeap(const CSR& g, ShortestPaths& sp)
+{
+	IndexedHeap heap(g.size());
+	heap.pushOrDecrease(sp.source, 0);
+
+	while (!heap.empty())
+	{
+		size_t d = heap.topKey();
+		size_t u = heap.pop();
+
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			size_t v = g.targets[e];
+			size_t nd = d + g.weights[e];
+			if (nd < sp.dist[v])
+			{
+				sp.dist[v] = nd;
+				sp.parent[v] = u;
+				heap.pushOrDecrease(v, nd);
+			}
+		}
+	}
+}
+
+// Dijkstra's algorithm with a radix heap, stale heap entries are skipped when popped
+inline void dijkstra_radixHeap(const CSR& g, ShortestPaths& sp)
+{
+	RadixHeap heap;
+	heap.push(0, sp.source);
+
+	while (!heap.empty())
+	{
+		std::pair<size_t, size_t> top = heap.pop();
+		size_t d = top.first, u = top.second;
+		if (d > sp.dist[u])
+			continue;
+
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+		{
+			size_t v = g.targets[e];
+			size_t nd = d + g.weights[e];
+			if (nd < sp.dist[v])
+			{
+				sp.dist[v] = nd;
+				sp.parent[v] = u;
+				heap.push(nd, v);
+			}
+		}
+	}
+}
+
+// single-source shortest paths from source (edge weights are non-negative)
+// radix_heap picks the radix heap variant, which is usually faster for integer weights on large graphs
+inline ShortestPaths dijkstra(const CSR& g, size_t source, bool radix_heap = false)
+{
+	ShortestPaths sp;
+	sp.source = source;
+	sp.dist.assign(g.size(), UNREACHABLE);
+	sp.parent.assign(g.size(), NO_PARENT);
+
+	if (!g.exists(source))
+		return sp;
+
+	sp.dist[source] = 0;
+
+	if (radix_heap)
+		dijkstra_radixHeap(g, sp);
+	else
+		dijkstra_binaryHeap(g, sp);
+
+	return sp;
+}
+
+// result of an all-pairs shortest path computation, as two n x n row-major matrices
+// dist[i * n + j] = cost of the shortest path from i to j (NO_PATH if there is none)
+// paths[i * n + j] = an intermediate vertex k on that path, -1 if the path is the direct edge (i, j),
+// NO_PATH if there is no path (this is the layout printPath_util() walks)
+struct AllPairsPaths
+{
+	size_t n;
+	std::vector<size_t> dist;
+	std::vector<int> paths;
+};
+
+// relaxes every pair in tile (ib, jb) through the intermediate vertices of tile kb
+// the inner loop is branch-free so the compiler can vectorize it as a min-plus row update
+inline void floydWarshall_tile(AllPairsPaths& ap, size_t ib, size_t jb, size_t kb)
+{
+	size_t n = ap.n;
+	size_t i_end = std::min(ib + FW_BLOCK, n);
+	size_t j_end = std::min(jb + FW_BLOCK, n);
+	size_t k_end = std::min(kb + FW_BLOCK, n);
+
+	for (size_t k = kb; k < k_end; k++)
+	{
+		const size_t* krow = &ap.dist[k * n];
+		for (size_t i = ib; i < i_end; i++)
+		{
+			size_t dik = ap.dist[i * n + k];
+			if (dik == NO_PATH)
+				continue;
+
+			// NO_PATH + anything is never smaller than an existing entry, so no extra checks are needed
+			size_t* drow = &ap.dist[i * n];
+			int* prow = &ap.paths[i * n];
+			for (size_t j = jb; j < j_end; j++)
+			{
+				size_t candidate = dik + krow[j];
+				bool better = candidate < drow[j];
+				drow[j] = better ? candidate : drow[j];
+				prow[j] = better ? (int)k : prow[j];
+			}
+		}
+	}
+}
+
+// one round of blocked Floyd-Warshall for the intermediate vertices in tile kb:
+// the diagonal tile first, then the tiles in its row and column, then all the others
+// tiles within the second and third phase don't depend on each other, so with a pool they are spread
+// across threads and the result is identical to the sequential one
+inline void floydWarshall_round(AllPairsPaths& ap, size_t kb, ThreadPool* pool)
+{
+	size_t tiles = (ap.n + FW_BLOCK - 1) / FW_BLOCK;
+
+	floydWarshall_tile(ap, kb, kb, kb);
+
+	auto row_and_column = [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t t = lo; t < hi; t++)
+			if (t * FW_BLOCK != kb)
+			{
+				floydWarshall_tile(ap, kb, t * FW_BLOCK, kb);
+				floydWarshall_tile(ap, t * FW_BLOCK, kb, kb);
+			}
+	};
+
+	// one task per row of tiles
+	auto remaining = [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t t = lo; t < hi; t++)
+			for (size_t jb = 0; jb < ap.n; jb += FW_BLOCK)
+				if (t * FW_BLOCK != kb && jb != kb)
+					floydWarshall_tile(ap, t * FW_BLOCK, jb, kb);
+	};
+
+	if (pool)
+	{
+		pool->parallelFor(0, tiles, 1, row_and_column);
+		pool->parallelFor(0, tiles, 1, remaining);
+	}
+	else
+	{
+		row_and_column(0, tiles, 0);
+		remaining(0, tiles, 0);
+	}
+}
+
+// fills the matrices with the edges of the graph
+inline void floydWarshall_init(const CSR& g, AllPairsPaths& ap)
+{
+	ap.n = g.size();
+	ap.dist.assign(ap.n * ap.n, NO_PATH);
+	ap.paths.assign(ap.n * ap.n, (int)NO_PATH);
+
+	// parallel edges between the same pair keep the lightest one
+	for (size_t i = 0; i < ap.n; i++)
+		for (size_t e = g.edgeBegin(i); e < g.edgeEnd(i); e++)
+			ap.dist[i * ap.n + g.targets[e]] = std::min(ap.dist[i * ap.n + g.targets[e]], g.weights[e]);
+}
+
+// marks the pairs that are joined by a direct edge, once all rounds are done
+inline void floydWarshall_finish(AllPairsPaths& ap)
+{
+	for (size_t i = 0; i < ap.n * ap.n; i++)
+		if (ap.dist[i] != NO_PATH && ap.paths[i] == (int)NO_PATH)
+			ap.paths[i] = -1;
+}
+
+// all-pairs shortest paths using cache-blocked Floyd-Warshall
+// (runs on the threads of pool if one is given, the result is the same either way)
+inline AllPairsPaths floydWarshall(const CSR& g, ThreadPool* pool = nullptr)
+{
+	AllPairsPaths ap;
+	floydWarshall_init(g, ap);
+
+	for (size_t kb = 0; kb < ap.n; kb += FW_BLOCK)
+		floydWarshall_round(ap, kb, pool);
+
+	floydWarshall_finish(ap);
+	return ap;
+}
+
+// all-pairs shortest paths by running Dijkstra from every vertex in parallel, much less work on sparse graphs
+// dist comes out exactly as floydWarshall() computes it, including dist[i][i] = shortest cycle through i
+// paths holds the last vertex before j on the path found (-1 if that is i itself), which printPath_util()
+// expands the same way, but where two paths cost the same it may pick a different one than floydWarshall()
+// so allPairsShortestPaths() never picks it, callers that don't need floydWarshall()'s paths opt in by calling it
+inline AllPairsPaths allPairsDijkstra(const CSR& g, ThreadPool& pool)
+{
+	AllPairsPaths ap;
+	ap.n = g.size();
+	ap.dist.assign(ap.n * ap.n, NO_PATH);
+	ap.paths.assign(ap.n * ap.n, (int)NO_PATH);
+
+	// in-edges give the shortest cycle through each source
+	CSR in_edges = g.reversed();
+
+	pool.parallelFor(0, ap.n, 16, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t i = lo; i < hi; i++)
+		{
+			if (!g.exists(i))
+				continue;
+
+			ShortestPaths sp = dijkstra(g, i);
+			size_t* drow = &ap.dist[i * ap.n];
+			int* prow = &ap.paths[i * ap.n];
+
+			for (size_t j = 0; j < ap.n; j++)
+				if (j != i && sp.dist[j] != UNREACHABLE)
+				{
+					drow[j] = sp.dist[j];
+					prow[j] = (sp.parent[j] == i) ? -1 : (int)sp.parent[j];
+				}
+
+			for (size_t e = in_edges.edgeBegin(i); e < in_edges.edgeEnd(i); e++)
+			{
+				size_t u = in_edges.targets[e];
+				if (sp.dist[u] != UNREACHABLE && sp.dist[u] + in_edges.weights[e] < drow[i])
+				{
+					drow[i] = sp.dist[u] + in_edges.weights[e];
+					prow[i] = (u == i) ? -1 : (int)u;
+				}
+			}
+		}
+	});
+
+	return ap;
+}
+
+// multithreaded all-pairs shortest paths: the blocked Floyd-Warshall on every thread of pool,
+// with the same dist and paths as the sequential floydWarshall(g)
+// (allPairsDijkstra() does less work on sparse graphs, but may break ties between paths differently)
+inline AllPairsPaths allPairsShortestPaths(const CSR& g, ThreadPool& pool)
+{
+	return floydWarshall(g, &pool);
+}
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed set of worker threads for data-parallel loops
+// parallelFor() splits a range into chunks that idle threads keep grabbing from a shared atomic cursor,
+// so a thread that finishes early takes over work the others haven't started yet
+// (work sharing rather than work stealing: every loop here is a flat range known up front, which one cursor
+// balances with a single atomic add per chunk, without per-thread deques)
+// the calling thread works too, and parallelFor() must not be called from inside another parallelFor()
+// jobs run one at a time: callers on different threads can share a pool (e.g. defaultThreadPool()),
+// each waits for the job before it to finish
+class ThreadPool
+{
+	std::vector<std::thread> workers;
+
+	// held by runOnAll() for the whole job, so a second caller can't replace job while the workers run it
+	std::mutex submit_mtx;
+
+	std::mutex mtx;
+	std::condition_variable job_ready;
+	std::condition_variable job_done;
+
+	// job the workers run next, called with the thread number (1 .. workers.size())
+	std::function<void(size_t)> job;
+
+	// incremented for every new job so workers can tell it apart from the one they already ran
+	size_t generation;
+
+	// workers still running the current job
+	size_t busy;
+
+	bool stopping;
+
+	void workerLoop(size_t thread_id)
+	{
+		size_t seen = 0;
+		while (true)
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			job_ready.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+			lock.unlock();
+
+			job(thread_id);
+
+			lock.lock();
+			if (--busy == 0)
+				job_done.notify_one();
+		}
+	}
+
+public:
+	// threads = total number of threads including the caller (0 = one per hardware thread)
+	ThreadPool(size_t threads = 0)
+	{
+		if (threads == 0)
+			threads = std::thread::hardware_concurrency();
+		if (threads == 0)
+			threads = 1;
+
+		generation = 0;
+		busy = 0;
+		stopping = false;
+
+		for (size_t i = 1; i < threads; i++)
+			workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			stopping = true;
+		}
+		job_ready.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// number of threads that run a job, including the caller
+	size_t size() const { return workers.size() + 1; }
+
+	// runs fn(thread_id) once on every thread (thread_id = 0 .. size() - 1) and waits for all of them
+	void runOnAll(const std::function<void(size_t)>& fn)
+	{
+		if (workers.empty())
+		{
+			fn(0);
+			return;
+		}
+
+		std::lock_guard<std::mutex> submit(submit_mtx);
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			job = fn;
+			busy = workers.size();
+			generation++;
+		}
+		job_ready.notify_all();
+
+		fn(0);
+
+		std::unique_lock<std::mutex> lock(mtx);
+		job_done.wait(lock, [&] { return busy == 0; });
+		job = nullptr;
+	}
+
+	// calls fn(lo, hi, thread_id) on chunks [lo, hi) of [begin, end), at most grain indices per chunk
+	template <class F>
+	void parallelFor(size_t begin, size_t end, size_t grain, F&& fn)
+	{
+		if (begin >= end)
+			return;
+		if (grain == 0)
+			grain = 1;
+
+		// a single chunk isn't worth waking the workers for
+		if (end - begin <= grain || workers.empty())
+		{
+			for (size_t lo = begin; lo < end; lo += grain)
+				fn(lo, (end - lo > grain) ? lo + grain : end, (size_t)0);
+			return;
+		}
+
+		std::atomic<size_t> cursor(begin);
+		runOnAll([&](size_t thread_id)
+		{
+			while (true)
+			{
+				size_t lo = cursor.fetch_add(grain, std::memory_order_relaxed);
+				if (lo >= end)
+					break;
+				fn(lo, (end - lo > grain) ? lo + grain : end, thread_id);
+			}
+		});
+	}
+};
+
+// sorts items by comp on the threads of pool: every thread sorts one slice,
+// then neighbouring slices are merged in rounds (each round's merges also run in parallel)
+template <class T, class Compare>
+void parallelSort(std::vector<T>& items, Compare comp, ThreadPool& pool)
+{
+	size_t n = items.size();
+	size_t parts = pool.size();
+	if (parts == 1 || n < 4096)
+	{
+		std::sort(items.begin(), items.end(), comp);
+		return;
+	}
+
+	std::vector<size_t> bounds(parts + 1);
+	for (size_t p = 0; p <= parts; p++)
+		bounds[p] = n * p / parts;
+
+	pool.parallelFor(0, parts, 1, [&](size_t lo, size_t hi, size_t)
+	{
+		for (size_t p = lo; p < hi; p++)
+			std::sort(items.begin() + bounds[p], items.begin() + bounds[p + 1], comp);
+	});
+
+	for (size_t width = 1; width < parts; width *= 2)
+		pool.parallelFor(0, (parts + 2 * width - 1) / (2 * width), 1, [&](size_t lo, size_t hi, size_t)
+		{
+			for (size_t q = lo; q < hi; q++)
+			{
+				size_t first = q * 2 * width;
+				size_t middle = std::min(first + width, parts);
+				size_t last = std::min(first + 2 * width, parts);
+				if (middle < last)
+					std::inplace_merge(items.begin() + bounds[first], items.begin() + bounds[middle],
+						items.begin() + bounds[last], comp);
+			}
+		});
+}
+
+// pool shared by the graph algorithms when the caller doesn't pass one, created on first use
+inline ThreadPool& defaultThreadPool()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+#endif
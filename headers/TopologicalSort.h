@@ -0,0 +1,163 @@
+#ifndef TOPOLOGICAL_SORT_H
+#define TOPOLOGICAL_SORT_H
+
+#include "CSR.h"
+#include "ThreadPool.h"
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// topological order of a directed graph, split into waves:
+// a vertex is in wave w if the longest path leading to it has w edges, so no vertex depends on another one in
+// its own wave, and every wave only depends on the waves before it (wave w is order[wave_start[w] .. wave_start[w + 1]),
+// sorted by vertex)
+// if the graph has a cycle, acyclic is false, order and wave_start only cover the vertices that don't depend on it,
+// and cycle holds one cycle (an edge leads from every vertex to the next one, and from the last one to the first)
+struct TopologicalOrder
+{
+	bool acyclic;
+	std::vector<size_t> order;
+	std::vector<size_t> wave_start;
+	std::vector<size_t> cycle;
+
+	size_t waves() const { return wave_start.size() - 1; }
+};
+
+// finds a cycle among the vertices Kahn's algorithm couldn't place (placed[v] == false)
+// every one of them has an edge coming in from another one, so walking those edges backwards has to repeat a vertex
+inline std::vector<size_t> topologicalSort_findCycle(const CSR& g, const std::vector<bool>& placed)
+{
+	const size_t NONE = SIZE_MAX;
+	size_t n = g.size();
+
+	std::vector<size_t> pred(n, NONE);
+	size_t start = NONE;
+	for (size_t u = 0; u < n; u++)
+		if (g.exists(u) && !placed[u])
+		{
+			start = u;
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				if (!placed[g.targets[e]])
+					pred[g.targets[e]] = u;
+		}
+
+	// walk back until a vertex repeats, that vertex is on a cycle
+	std::vector<bool> walked(n, false);
+	size_t v = start;
+	while (!walked[v])
+	{
+		walked[v] = true;
+		v = pred[v];
+	}
+
+	std::vector<size_t> cycle;
+	size_t u = v;
+	do
+	{
+		cycle.push_back(u);
+		u = pred[u];
+	} while (u != v);
+
+	std::reverse(cycle.begin(), cycle.end());
+	return cycle;
+}
+
+// Kahn's algorithm, wave by wave: starts from the vertices nothing leads to, and every vertex joins the next wave
+// once all the vertices leading to it have been placed
+// a single pass over the edges, which also tells whether the graph has a cycle
+// with a pool, the in-degrees are counted and each wave is expanded on all of its threads,
+// a vertex going to whichever thread takes its in-degree down to 0 (the waves come out the same either way)
+inline TopologicalOrder kahnTopologicalSort(const CSR& g, ThreadPool* pool = nullptr)
+{
+	size_t n = g.size();
+	TopologicalOrder topo;
+	topo.order.reserve(n);
+	topo.wave_start.push_back(0);
+
+	// edges into every vertex from vertices that haven't been placed yet
+	std::vector<size_t> in_degree(n, 0);
+
+	if (pool)
+	{
+		pool->parallelFor(0, n, 4096, [&](size_t lo, size_t hi, size_t)
+		{
+			for (size_t u = lo; u < hi; u++)
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+					std::atomic_ref<size_t>(in_degree[g.targets[e]]).fetch_add(1, std::memory_order_relaxed);
+		});
+	}
+	else
+	{
+		for (size_t e = 0; e < g.edgeCount(); e++)
+			in_degree[g.targets[e]]++;
+	}
+
+	size_t live = 0;
+	for (size_t v = 0; v < n; v++)
+		if (g.exists(v))
+		{
+			live++;
+			if (in_degree[v] == 0)
+				topo.order.push_back(v);
+		}
+
+	// vertices found by each thread for the next wave
+	std::vector<std::vector<size_t>> found(pool ? pool->size() : 1);
+
+	size_t wave_begin = 0;
+	while (wave_begin < topo.order.size())
+	{
+		size_t wave_end = topo.order.size();
+		topo.wave_start.push_back(wave_end);
+
+		if (pool)
+		{
+			pool->parallelFor(wave_begin, wave_end, 64, [&](size_t lo, size_t hi, size_t thread_id)
+			{
+				for (size_t i = lo; i < hi; i++)
+				{
+					size_t u = topo.order[i];
+					for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+					{
+						size_t v = g.targets[e];
+						if (std::atomic_ref<size_t>(in_degree[v]).fetch_sub(1, std::memory_order_relaxed) == 1)
+							found[thread_id].push_back(v);
+					}
+				}
+			});
+
+			for (std::vector<size_t>& mine : found)
+			{
+				topo.order.insert(topo.order.end(), mine.begin(), mine.end());
+				mine.clear();
+			}
+		}
+		else
+		{
+			for (size_t i = wave_begin; i < wave_end; i++)
+			{
+				size_t u = topo.order[i];
+				for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+					if (--in_degree[g.targets[e]] == 0)
+						topo.order.push_back(g.targets[e]);
+			}
+		}
+
+		std::sort(topo.order.begin() + wave_end, topo.order.end());
+		wave_begin = wave_end;
+	}
+
+	topo.acyclic = (topo.order.size() == live);
+	if (!topo.acyclic)
+	{
+		std::vector<bool> placed(n, false);
+		for (size_t v : topo.order)
+			placed[v] = true;
+		topo.cycle = topologicalSort_findCycle(g, placed);
+	}
+
+	return topo;
+}
+
+#endif
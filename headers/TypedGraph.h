@@ -0,0 +1,450 @@
+#ifndef TYPED_GRAPH_H
+#define TYPED_GRAPH_H
+
+#include "Graph.h"
+#include <stdint.h>
+#include <limits>
+#include <span>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// weight type of an unweighted Graph: takes no space in a node, every edge weighs 1
+struct NoWeight
+{
+	NoWeight() {}
+	NoWeight(size_t) {}
+	operator size_t() const { return 1; }
+};
+
+// single node of the adjacency list of a Graph, holding only what its types need
+// (with 32-bit indices a node takes 16 bytes, unweighted or with a weight of up to 4 bytes, a ListNode takes 32)
+template <class VertexId, class Weight>
+struct GraphNode
+{
+	VertexId index;
+	[[no_unique_address]] Weight weight;
+	GraphNode* next;
+};
+
+// compressed sparse row (CSR) snapshot of a Graph, with the same layout, accessors and Cursor as CSR
+// but its own index and weight types (an unweighted graph stores no weights at all)
+// BasicDFS and bfs() run on it directly
+template <class VertexId, class Weight>
+class GraphCSR
+{
+public:
+	static constexpr bool weighted = !std::is_same<Weight, NoWeight>::value;
+
+	// row u is [offsets[u], offsets[u + 1]), offsets stay size_t since there can be more edges than indices
+	std::vector<size_t> offsets;
+	std::vector<VertexId> targets;
+
+	// weight of each edge (parallel to targets), empty in an unweighted graph
+	std::vector<Weight> weights;
+
+	// present[u] is 0 for indices whose vertex was removed
+	std::vector<unsigned char> present;
+
+	GraphCSR() : offsets(1, 0) {}
+
+	size_t size() const { return present.size(); }
+	size_t edgeCount() const { return targets.size(); }
+	bool exists(size_t u) const { return u < size() && present[u]; }
+	size_t edgeBegin(size_t u) const { return offsets[u]; }
+	size_t edgeEnd(size_t u) const { return offsets[u + 1]; }
+	size_t degree(size_t u) const { return offsets[u + 1] - offsets[u]; }
+
+	// weight of the edge stored at targets[e]
+	Weight weight(size_t e) const
+	{
+		if constexpr (weighted)
+			return weights[e];
+		else
+			return Weight();
+	}
+
+	// reads the row of one vertex, an edge at a time (see CSR::Cursor)
+	class Cursor
+	{
+	public:
+		const VertexId* targets;
+		const Weight* weights;
+
+		size_t edge;
+		size_t end;
+		size_t vertex;
+
+		bool next()
+		{
+			if (edge == end)
+				return false;
+			vertex = targets[edge++];
+			return true;
+		}
+
+		Weight weight() const
+		{
+			if constexpr (weighted)
+				return weights[edge - 1];
+			else
+				return Weight();
+		}
+	};
+
+	Cursor row(size_t u) const
+	{
+		return Cursor{targets.data(), weights.data(), offsets[u], offsets[u + 1], u};
+	}
+
+	// returns the same graph with every edge reversed
+	GraphCSR reversed() const
+	{
+		GraphCSR r;
+		size_t n = size(), m = edgeCount();
+		r.present = present;
+		r.offsets.assign(n + 1, 0);
+		r.targets.resize(m);
+		if constexpr (weighted)
+			r.weights.resize(m);
+
+		for (size_t e = 0; e < m; e++)
+			r.offsets[targets[e] + 1]++;
+		for (size_t i = 0; i < n; i++)
+			r.offsets[i + 1] += r.offsets[i];
+
+		std::vector<size_t> fill(r.offsets.begin(), r.offsets.end() - 1);
+		for (size_t u = 0; u < n; u++)
+			for (size_t e = offsets[u]; e < offsets[u + 1]; e++)
+			{
+				size_t pos = fill[targets[e]]++;
+				r.targets[pos] = (VertexId)u;
+				if constexpr (weighted)
+					r.weights[pos] = weights[e];
+			}
+		return r;
+	}
+};
+
+// adjacency list graph with its index type, weight type and directedness fixed at compile time
+// VertexId = unsigned type of vertex indices (uint32_t is enough for 4 billion vertices, and halves a node)
+// Weight   = NoWeight for an unweighted graph, or an arithmetic type (uint16_t, float, double, ...)
+// Directed = whether edges go one way
+// works like AdjList (pooled lists, a lazily built CSR, indices of removed vertices stay reserved),
+// but addEdge() and the traversals have no directed / weighted checks left to make at run time
+// toCSR() gives the size_t CSR every algorithm of the library runs on (for unweighted or whole-number weights only)
+template <class VertexId = uint32_t, class Weight = NoWeight, bool Directed = true>
+class Graph
+{
+public:
+	static_assert(std::is_unsigned<VertexId>::value, "vertex indices have to be unsigned");
+
+	static constexpr bool weighted = !std::is_same<Weight, NoWeight>::value;
+	static constexpr bool directed = Directed;
+
+	typedef GraphNode<VertexId, Weight> Node;
+
+	// list of one vertex index (head is nullptr and present false once the vertex is removed)
+	struct Row
+	{
+		Node* head;
+		Node* tail;
+		size_t size;
+		bool present;
+	};
+
+	// every node of the graph is allocated from this pool and freed all at once when the graph is destroyed
+	Pool<Node> node_pool;
+
+	std::vector<Row> rows;
+
+	size_t vertices;
+
+	// an undirected edge is stored in both lists but counted once
+	size_t edges;
+
+	// where messages about graph modifications go, logging is off while this is empty
+	LogSink log_sink;
+
+	// contiguous copy of the lists, rebuilt lazily by getCSR() after the graph has been modified
+	GraphCSR<VertexId, Weight> csr;
+	bool csr_valid;
+
+	// csr with every edge reversed (only built for directed graphs), rebuilt lazily by getReverseCSR()
+	GraphCSR<VertexId, Weight> reverse_csr;
+	bool reverse_csr_valid;
+
+	Graph(size_t number = 0)
+	{
+		vertices = 0;
+		edges = 0;
+		csr_valid = false;
+		reverse_csr_valid = false;
+
+		rows.reserve(number);
+		for (size_t i = 0; i < number; i++)
+			addVertex();
+	}
+
+	~Graph()
+	{
+		node_pool.release();
+	}
+
+	Graph(const Graph&) = delete;
+	Graph& operator=(const Graph&) = delete;
+
+	// adds a vertex with the next index, returns false once VertexId has no indices left
+	bool addVertex()
+	{
+		if (rows.size() == std::numeric_limits<VertexId>::max())
+		{
+			if (log_sink)
+				log("Can't add a node, every index of the index type is taken!");
+			return false;
+		}
+
+		csr_valid = false;
+		rows.push_back(Row{nullptr, nullptr, 0, true});
+		vertices++;
+		return true;
+	}
+
+	// removes vertex u and every edge to or from it (its index stays reserved)
+	GraphStatus removeVertex(size_t u)
+	{
+		if (!exists(u))
+		{
+			if (log_sink)
+				log("Node " + std::to_string(u) + " doesn't exist!");
+			return GRAPH_NO_SUCH_VERTEX;
+		}
+
+		csr_valid = false;
+
+		if constexpr (Directed)
+		{
+			// edges to u can be in any list
+			for (size_t w = 0; w < rows.size(); w++)
+				if (w != u)
+					while (removeNode(rows[w], u))
+						edges--;
+		}
+		else
+		{
+			// edges to u are only in the lists of its neighbours
+			for (Node* ptr = rows[u].head; ptr != nullptr; ptr = ptr->next)
+				removeNode(rows[ptr->index], u);
+		}
+
+		edges -= rows[u].size;
+		while (removeNode(rows[u], SIZE_MAX, true));
+		rows[u].present = false;
+		vertices--;
+		return GRAPH_OK;
+	}
+
+	// adds edge (u -> v), and (v -> u) too if the graph is undirected
+	// weight is ignored by an unweighted graph, and taken as 1 if it isn't positive
+	GraphStatus addEdge(size_t u, size_t v, Weight weight = Weight(1))
+	{
+		if (u == v)
+		{
+			if (log_sink)
+				log("Can't add edge (" + std::to_string(u) + ", " + std::to_string(v) + ") because can't have an edge to self!");
+			return GRAPH_SELF_LOOP;
+		}
+
+		if (!exists(u) || !exists(v))
+		{
+			if (log_sink)
+				log("One or both of the node indices provided don't exist!");
+			return GRAPH_NO_SUCH_VERTEX;
+		}
+
+		if constexpr (weighted)
+		{
+			if (!(weight > Weight(0)))
+			{
+				if (log_sink)
+					log("Invalid weight passed to Graph::addEdge(), so assuming weight 1");
+				weight = Weight(1);
+			}
+		}
+
+		if (log_sink)
+		{
+			if constexpr (weighted)
+				log("Inserting edge (" + std::to_string(u) + ", " + std::to_string(v) + ") with weight " + std::to_string(weight));
+			else
+				log("Inserting edge (" + std::to_string(u) + ", " + std::to_string(v) + ")");
+		}
+
+		csr_valid = false;
+		insertNode(rows[u], v, weight);
+		if constexpr (!Directed)
+			insertNode(rows[v], u, weight);
+
+		edges++;
+		return GRAPH_OK;
+	}
+
+	// adds every (u, v, weight) edge in edge_list, in order, as if addEdge() was called on each one
+	// (takes the same edge lists as AdjList::addEdges(), e.g. the edges of an ImportedGraph)
+	// returns GRAPH_OK, or the status of the first edge that couldn't be added (the rest are still added)
+	GraphStatus addEdges(std::span<const std::tuple<size_t, size_t, size_t>> edge_list)
+	{
+		node_pool.reserve(edge_list.size() * (Directed ? 1 : 2));
+
+		GraphStatus result = GRAPH_OK;
+		for (const std::tuple<size_t, size_t, size_t>& edge : edge_list)
+		{
+			GraphStatus status = addEdge(std::get<0>(edge), std::get<1>(edge), (Weight)std::get<2>(edge));
+			if (result == GRAPH_OK)
+				result = status;
+		}
+		return result;
+	}
+
+	// removes one edge (u, v) (and (v, u) if the graph is undirected)
+	GraphStatus removeEdge(size_t u, size_t v)
+	{
+		if (!exists(u) || !exists(v) || !removeNode(rows[u], v))
+		{
+			if (log_sink)
+				log("Edge with specified indices not found !!");
+			return GRAPH_NO_SUCH_EDGE;
+		}
+
+		if constexpr (!Directed)
+			removeNode(rows[v], u);
+
+		edges--;
+		csr_valid = false;
+		return GRAPH_OK;
+	}
+
+	// returns whether a vertex with this index exists
+	bool exists(size_t u) const { return u < rows.size() && rows[u].present; }
+
+	// returns the CSR form of the graph, rebuilding it first if the graph changed since the last call
+	const GraphCSR<VertexId, Weight>& getCSR()
+	{
+		if (csr_valid)
+			return csr;
+
+		size_t n = rows.size();
+		csr.offsets.assign(n + 1, 0);
+		csr.present.assign(n, 0);
+		for (size_t u = 0; u < n; u++)
+		{
+			csr.offsets[u + 1] = csr.offsets[u] + rows[u].size;
+			csr.present[u] = rows[u].present;
+		}
+
+		size_t m = csr.offsets[n];
+		csr.targets.resize(m);
+		if constexpr (weighted)
+			csr.weights.resize(m);
+
+		for (size_t u = 0, e = 0; u < n; u++)
+			for (Node* ptr = rows[u].head; ptr != nullptr; ptr = ptr->next, e++)
+			{
+				csr.targets[e] = ptr->index;
+				if constexpr (weighted)
+					csr.weights[e] = ptr->weight;
+			}
+
+		csr_valid = true;
+		reverse_csr_valid = false;
+		return csr;
+	}
+
+	// returns the CSR of the graph with its edges reversed (the CSR itself for undirected graphs)
+	const GraphCSR<VertexId, Weight>& getReverseCSR()
+	{
+		const GraphCSR<VertexId, Weight>& g = getCSR();
+		if constexpr (!Directed)
+			return g;
+
+		if (!reverse_csr_valid)
+		{
+			reverse_csr = g.reversed();
+			reverse_csr_valid = true;
+		}
+		return reverse_csr;
+	}
+
+	// the graph as a size_t CSR, for the algorithms that only run on one
+	// the weights are copied exactly, so a graph with real weights can't be converted: rounding them would
+	// quietly change what Dijkstra, the MSTs or Floyd-Warshall compute
+	// (addEdge() keeps every weight positive, so a whole-number weight is at least 1 here)
+	CSR toCSR()
+	{
+		static_assert(!weighted || std::is_integral<Weight>::value,
+			"toCSR() needs whole-number weights, real weights would have to be rounded");
+
+		const GraphCSR<VertexId, Weight>& g = getCSR();
+
+		std::vector<size_t> weights(g.edgeCount(), 1);
+		if constexpr (weighted)
+			for (size_t e = 0; e < g.edgeCount(); e++)
+				weights[e] = (size_t)g.weights[e];
+
+		CSR result;
+		result.assign(g.offsets, std::vector<size_t>(g.targets.begin(), g.targets.end()), std::move(weights), g.present);
+		return result;
+	}
+
+	// shortest path (in edges) from source to every vertex, see bfs()
+	ShortestPaths BFS(size_t source)
+	{
+		const GraphCSR<VertexId, Weight>& g = getCSR();
+		return bfs(g, getReverseCSR(), source);
+	}
+
+	// sends a message to log_sink if one is set
+	void log(const std::string& message)
+	{
+		if (log_sink)
+			log_sink(message);
+	}
+
+private:
+	// appends v to the end of row
+	void insertNode(Row& row, size_t v, Weight weight)
+	{
+		Node* node = node_pool.create(Node{(VertexId)v, weight, nullptr});
+		if (row.head == nullptr)
+			row.head = node;
+		else
+			row.tail->next = node;
+		row.tail = node;
+		row.size++;
+	}
+
+	// unlinks the first node of row that leads to v (or the first node at all if any is set),
+	// returns false if there is none
+	bool removeNode(Row& row, size_t v, bool any = false)
+	{
+		Node* prev = nullptr;
+		for (Node* ptr = row.head; ptr != nullptr; prev = ptr, ptr = ptr->next)
+			if (any || ptr->index == v)
+			{
+				if (prev == nullptr)
+					row.head = ptr->next;
+				else
+					prev->next = ptr->next;
+				if (row.tail == ptr)
+					row.tail = prev;
+
+				node_pool.destroy(ptr);
+				row.size--;
+				return true;
+			}
+		return false;
+	}
+};
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <utility>
+#include <vector>
+
+// disjoint sets of the elements 0 .. n-1, with union by size and path compression
+class UnionFind
+{
+public:
+	std::vector<size_t> parent;
+
+	// number of elements in the set, only meaningful for roots
+	std::vector<size_t> set_size;
+
+	// number of disjoint sets
+	size_t sets;
+
+	UnionFind(size_t n = 0)
+	{
+		reset(n);
+	}
+
+	// makes every element its own set again
+	void reset(size_t n)
+	{
+		parent.resize(n);
+		set_size.assign(n, 1);
+		for (size_t i = 0; i < n; i++)
+			parent[i] = i;
+		sets = n;
+	}
+
+	// adds a new element in a set of its own, returns it
+	size_t add()
+	{
+		parent.push_back(parent.size());
+		set_size.push_back(1);
+		sets++;
+		return parent.size() - 1;
+	}
+
+	size_t size() const { return parent.size(); }
+
+	// returns the root of the set x is in, pointing every element on the way at its grandparent
+	size_t find(size_t x)
+	{
+		while (parent[x] != x)
+		{
+			parent[x] = parent[parent[x]];
+			x = parent[x];
+		}
+		return x;
+	}
+
+	// find() without path compression, safe to call from several threads while nobody modifies the sets
+	size_t findRoot(size_t x) const
+	{
+		while (parent[x] != x)
+			x = parent[x];
+		return x;
+	}
+
+	// merges the sets of a and b, returns false if they already were in the same set
+	bool unite(size_t a, size_t b)
+	{
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return false;
+
+		if (set_size[a] < set_size[b])
+			std::swap(a, b);
+		parent[b] = a;
+		set_size[a] += set_size[b];
+		sets--;
+		return true;
+	}
+
+	bool connected(size_t a, size_t b) { return find(a) == find(b); }
+};
+
+#endif
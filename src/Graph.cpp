@@ -17,6 +17,8 @@ void menu()
 		 << "2. Non-directed and weighted\n"
 		 << "3. Directed and non-weighted\n"
 		 << "4. Non-directed and non-weighted\n"
+		 << "5. Load a graph saved as a binary file\n"
+		 << "6. Import an edge list (.txt), Matrix Market (.mtx) or DIMACS (.gr) file\n"
 		 << "Enter a choice: ";
     cin >> init_choice;
 	
@@ -34,22 +36,80 @@ void menu()
 	case 4:
 		adjlist = new AdjList(0, false, false);
 		break;
+	case 5:
+	{
+		cout << "Enter the file name: ";
+		cin >> str;
+
+		CSRFileStatus status;
+		adjlist = AdjList::fromBinary(str, &status);
+		if (adjlist == nullptr)
+		{
+			cout << "\nCouldn't load a graph from " << str << ": " << csrFileStatusMessage(status) << "!\n";
+			exit(0);
+		}
+		break;
+	}
+	case 6:
+	{
+		cout << "Enter the file name: ";
+		cin >> str;
+
+		// the format is told by the file's extension, anything else is read as an edge list
+		GraphFileFormat format = FORMAT_EDGE_LIST;
+		if (str.size() >= 4 && str.compare(str.size() - 4, 4, ".mtx") == 0)
+			format = FORMAT_MATRIX_MARKET;
+		else if (str.size() >= 3 && str.compare(str.size() - 3, 3, ".gr") == 0)
+			format = FORMAT_DIMACS;
+
+		bool directed = true;
+		if (format == FORMAT_EDGE_LIST)
+		{
+			cout << "Is the graph directed? (y/n): ";
+			cin >> ch;
+			directed = (ch == 'y' || ch == 'Y');
+		}
+
+		ImportReport report;
+		adjlist = AdjList::fromText(str, format, directed, &report);
+		if (adjlist == nullptr)
+		{
+			cout << "\nCouldn't import a graph from " << str << "!\n";
+			exit(0);
+		}
+		cout << "\nImported " << adjlist->vertices << " vertices and " << adjlist->edges << " edges.\n";
+		if (report.bad_lines != 0)
+			cout << report.bad_lines << " lines couldn't be read and were left out, the first is line "
+				 << report.first_bad_line << ".\n";
+		if (report.self_loops != 0)
+			cout << report.self_loops << " self loops were left out.\n";
+		if (report.bad_weights != 0)
+			cout << report.bad_weights << " edges had a weight that isn't a whole number from 1 and were left out.\n";
+		if (!report.original_id.empty())
+			cout << "The ids in the file were too far apart, so the vertices were renumbered 0 to "
+				 << report.original_id.size() - 1 << " in the order of their ids.\n";
+		break;
+	}
 	default:
 		cout <<	"\nWrong choice entered! Enter a valid choice next time.\n";
 		exit(0);
 	}
 
+	// the library is silent by default, the interactive menu wants to see what happens
+	adjlist->log_sink = [](const string& message) { cout << message << "\n"; };
+
 	// UNCOMMENT THESE TO GET A BASIC GRAPH BY DEFAULT WHEN RUNNING PROGRAM
-	for (int i = 0; i < 5; i++)
-		adjlist->addList();
-	
-	adjlist->addEdge(0, 1, 2);
-	adjlist->addEdge(1, 2, 3);
-	adjlist->addEdge(0, 3, 6);
-	adjlist->addEdge(3, 1, 8);
-	adjlist->addEdge(3, 4, 9);
-	adjlist->addEdge(2, 4, 7);
-	adjlist->addEdge(1, 4, 5);
+	// (a loaded graph is used as it is)
+	if (init_choice != 5 && init_choice != 6)
+	{
+		for (int i = 0; i < 5; i++)
+			adjlist->addList();
+		
+		const tuple<size_t, size_t, size_t> default_edges[] = {
+			{0, 1, 2}, {1, 2, 3}, {0, 3, 6}, {3, 1, 8}, {3, 4, 9}, {2, 4, 7}, {1, 4, 5}
+		};
+		adjlist->addEdges(default_edges);
+	}
 
 	do
     {
@@ -65,9 +125,11 @@ void menu()
 			 << "6. Shortest path between any pair of nodes\n"
 			 << "7. Searching a value in the graph via BFS and DFS\n"
 			 << "8. Detect presence of a cycle in the graph\n"
-			 << "9. Calculate and display the minimum spanning tree\n"
+			 << "9. Calculate and display the minimum spanning tree (or forest)\n"
 			 << "10. Display all possible paths between a pair of nodes\n"
 			 << "11. Show the adjacency list\n"
+			 << "12. Display the k shortest paths between a pair of nodes\n"
+			 << "13. Save the graph as a binary file\n"
 			 << "Enter your choice: ";
         cin >> n;
         cout << "\n";
@@ -77,6 +139,7 @@ void menu()
         case 1:	// node operations
 			cout <<	"1. Add a node\n"
 			   	 << "2. Delete a node\n"
+				 << "3. Delete several nodes\n"
 				 << "Enter your choice: ";
 			cin >> subchoice;
 
@@ -97,11 +160,25 @@ void menu()
 
 				adjlist->removeList(node_to_remove);
 			}
+			else if (subchoice == 3)
+			{
+				int no_of_nodes;
+				cout << "How many nodes do you want to delete? : ";
+				cin >> no_of_nodes;
+
+				vector<size_t> nodes_to_remove(no_of_nodes > 0 ? no_of_nodes : 0);
+				cout << "Enter their indices: ";
+				for (size_t& node : nodes_to_remove)
+					cin >> node;
+
+				adjlist->removeLists(nodes_to_remove);
+			}
 			break;
 
 		case 2: // edge operations
 			cout <<	"1. Add one or more edges\n"
 			   	 <<	"2. Delete an edge\n"
+				 <<	"3. Check whether an edge exists\n"
 				 <<	"Enter your choice: ";
 			cin >> subchoice;
 			if (subchoice == 1)
@@ -136,6 +213,19 @@ void menu()
 
 				adjlist->removeEdge(u, v);
 			}
+			else if (subchoice == 3)
+			{
+				size_t u, v;
+				cout << "\nEnter start and end of edge to look for: ";
+				cin >> u >> v;
+
+				if (!adjlist->hasEdge(u, v))
+					cout << "\nThere is no edge (" << u << ", " << v << ").\n";
+				else if (adjlist->weighted)
+					cout << "\nEdge (" << u << ", " << v << ") exists, with weight " << adjlist->edgeWeight(u, v) << ".\n";
+				else
+					cout << "\nEdge (" << u << ", " << v << ") exists.\n";
+			}
 			break;
 		
 		case 3: // BFT, DFT and Topological Sort operations
@@ -170,16 +260,63 @@ void menu()
 			break;
 		
 		case 4:
-			adjlist->isConnected() ? cout << "\nGraph is connected!" : cout << "\nGraph is disconnected!";
+			if (adjlist->isConnected())
+				cout << "\nGraph is connected!";
+			else
+			{
+				Components cc = adjlist->ConnectedComponents();
+				cout << "\nGraph is disconnected! It has " << cc.count() << " components:\n";
+				printComponents(cc);
+			}
+
+			if (adjlist->directed)
+			{
+				Components scc = adjlist->StronglyConnectedComponents();
+				if (scc.count() <= 1)
+					cout << "\nGraph is strongly connected!";
+				else
+				{
+					cout << "\nGraph has " << scc.count() << " strongly connected components:\n";
+					printComponents(scc);
+
+					// only worth showing if some component has more than one node
+					if (scc.count() < adjlist->vertices)
+					{
+						cout << "\nCondensation (one node per strongly connected component):\n";
+						AdjList* dag = adjlist->Condensation(scc);
+						dag->show();
+						dag->TopologicalSort();
+						delete dag;
+					}
+				}
+			}
 			break;
 		
 		case 5:
-			adjlist->FloydWarshall(true);
+		{
+			size_t source;
+			cout << "Find shortest path with which vertex as source? [enter an index]: ";
+			cin >> source;
+
+			if (adjlist->findListWithIndex(source) == nullptr)
+			{
+				cout << "Enter the index of a node that exists!!";
+				break;
+			}
+
+			printPath(adjlist->Dijkstra(source));
+			cout << "\n";
 			break;
+		}
 
 		case 6:
-			adjlist->FloydWarshall(false);
+		{
+			AllPairsPaths ap = adjlist->AllPairsShortestPaths();
+			cout << "Actual paths with shortest distances"
+				 << " between every pair of vertices \n";
+			printShortestPath(ap, false);
 			break;
+		}
 
 		case 7:
 			cout << "1. Search using BFS\n"
@@ -191,10 +328,13 @@ void menu()
 			cout << "Enter value to search for: ";
 			cin >> u;
 
+			bool found;
 			if (subchoice == 1)
-				adjlist->searchBFT(u);
+				found = adjlist->searchBFT(u);
 			else
-				adjlist->searchDFT(0, u, false);
+				found = adjlist->searchDFT(0, u, false);
+
+			found ? cout << "\nNode " << u << " found!" : cout << "\nNode " << u << " not found!";
 			break;
 
 		case 8:
@@ -202,21 +342,79 @@ void menu()
 			break;
 		
 		case 9:
-			adjlist->Prim_MST();
+		{
+			cout << "1. Prim's algorithm (graph needs to be connected)\n"
+				 << "2. Kruskal's algorithm (minimum spanning forest)\n"
+				 << "3. Boruvka's algorithm (minimum spanning forest)\n"
+				 << "Enter your choice: ";
+			cin >> subchoice;
+			cout << "\n";
+
+			SpanningTree mst;
+			GraphStatus status;
+			if (subchoice == 2)
+				status = adjlist->Kruskal_MST(mst);
+			else if (subchoice == 3)
+				status = adjlist->Boruvka_MST(mst);
+			else
+				status = adjlist->Prim_MST(mst);
+
+			if (status == GRAPH_DIRECTED)
+				cout << "Graph needs to be undirected for it to have a minimum spanning tree!";
+			else if (status == GRAPH_DISCONNECTED)
+				cout << "Graph needs to be connected for it to have a minimum spanning tree!";
+			else
+			{
+				adjlist->printMST(mst);
+				cout << "Total weight: " << mst.total_weight << "\n";
+			}
 			break;
+		}
 
 		case 10:
 		{
 			size_t u, v;
 			cout << "\nEnter start and end nodes: ";
 			cin >> u >> v;
-			adjlist->printAllPaths(u, v);
+
+			// a dense graph can have more paths than anyone wants to read
+			PathLimits limits;
+			limits.max_paths = 1000;
+			limits.time_budget = 5;
+			adjlist->printAllPaths(u, v, limits);
 			break;
 		}
 		case 11:
 			adjlist->show();
 			break;
 
+		case 12:
+		{
+			size_t u, v, k;
+			cout << "\nEnter start and end nodes: ";
+			cin >> u >> v;
+			cout << "How many paths? : ";
+			cin >> k;
+
+			vector<WeightedPath> paths = adjlist->KShortestPaths(u, v, k);
+			if (paths.empty())
+				cout << "No path from " << u << " to " << v << "!";
+			for (const WeightedPath& path : paths)
+			{
+				for (size_t x : path.vertices)
+					cout << x << " ";
+				cout << "(cost " << path.length << ")\n";
+			}
+			break;
+		}
+
+		case 13:
+			cout << "Enter the file name: ";
+			cin >> str;
+			if (adjlist->saveBinary(str) == GRAPH_OK)
+				cout << "Saved the graph to " << str << "\n";
+			break;
+
         default: 
             break;
         }
@@ -225,6 +423,8 @@ void menu()
         cout << "\n\n";
         ch = str[0];
     }while(ch=='y' || ch=='Y');
+
+	delete adjlist;
 }
 
 int main()
@@ -0,0 +1,1169 @@
+// regression tests for the graph library, run by ctest (see CMakeLists.txt)
+// each test works out the same result two ways (e.g. sequentially and on a thread pool) on random graphs
+// and checks that they agree
+// usage: Graph_Tests [test name], runs every test if no name is given
+#include "Graph.h"
+#include "TypedGraph.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// assert() is compiled out of the optimised build, so failed checks are counted instead
+int failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			failures++; \
+		} \
+	} while (0)
+
+// more threads than the test machine may have, so the parallel code paths always split the work
+const size_t TEST_THREADS = 4;
+
+// graph with uniformly random edges (parallel edges included) and weights 1 .. 20,
+// then the given number of vertices removed, so the indices have gaps
+AdjList* randomGraph(size_t vertices, size_t edges, bool directed, bool weighted, size_t removed, unsigned seed)
+{
+	AdjList* adjlist = new AdjList(vertices, directed, weighted);
+	mt19937 rng(seed);
+
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	while (edge_list.size() < edges)
+	{
+		size_t u = rng() % vertices, v = rng() % vertices;
+		if (u != v)
+			edge_list.emplace_back(u, v, 1 + rng() % 20);
+	}
+	adjlist->addEdges(edge_list);
+
+	for (size_t i = 0; i < removed; i++)
+		adjlist->removeList(rng() % vertices);
+	return adjlist;
+}
+
+// blocked Floyd-Warshall on a pool against the sequential run, and allPairsDijkstra() distances against both
+void testFloydWarshall()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		// sizes around and past FW_BLOCK, so partial blocks are covered
+		size_t n = 20 + seed * 37;
+		AdjList* adjlist = randomGraph(n, n * (1 + seed % 4), seed % 2 == 0, true, seed % 3, seed);
+		const CSR& g = adjlist->getCSR();
+
+		AllPairsPaths sequential = floydWarshall(g);
+		AllPairsPaths parallel = floydWarshall(g, &pool);
+		AllPairsPaths chosen = allPairsShortestPaths(g, pool);
+		AllPairsPaths dijkstra = allPairsDijkstra(g, pool);
+
+		CHECK(parallel.dist == sequential.dist);
+		CHECK(parallel.paths == sequential.paths);
+		CHECK(chosen.dist == sequential.dist);
+		CHECK(chosen.paths == sequential.paths);
+		CHECK(dijkstra.dist == sequential.dist);
+
+		delete adjlist;
+	}
+}
+
+// direction-optimizing bfs() against parallelBfs() on a pool: same distances, and every parent one level up
+// with an edge to its child
+void testParallelBFS()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 6; seed++)
+	{
+		// dense enough for bfs() to switch to bottom-up steps
+		size_t n = 2000 + seed * 500;
+		AdjList* adjlist = randomGraph(n, n * (2 + 3 * (seed % 3)), seed % 2 == 0, false, 10, 100 + seed);
+		const CSR& g = adjlist->getCSR();
+		const CSR& in = adjlist->getReverseCSR();
+
+		size_t source = 0;
+		while (!g.exists(source))
+			source++;
+
+		ShortestPaths sequential = bfs(g, in, source);
+		ShortestPaths parallel = parallelBfs(g, source, pool);
+		CHECK(parallel.dist == sequential.dist);
+
+		for (const ShortestPaths* sp : {&sequential, &parallel})
+			for (size_t v = 0; v < g.size(); v++)
+			{
+				if (v == source || sp->dist[v] == UNREACHABLE)
+					continue;
+
+				size_t u = sp->parent[v];
+				CHECK(u < g.size() && sp->dist[u] + 1 == sp->dist[v]);
+				CHECK(adjlist->hasEdge(u, v));
+			}
+
+		delete adjlist;
+	}
+}
+
+// minimum spanning forest weight of the sequential Kruskal against Kruskal and Borůvka on a pool,
+// and against Prim on graphs that are connected
+void testSpanningTrees()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		// sparse graphs fall apart into several trees, the ring makes the others connected
+		size_t n = 100 + seed * 300;
+		bool connected = seed % 2 == 0;
+		AdjList* adjlist = randomGraph(n, connected ? 2 * n : n / 2, false, true, connected ? 0 : 5, 200 + seed);
+		if (connected)
+			for (size_t u = 0; u < n; u++)
+				adjlist->addEdge(u, (u + 1) % n, 20);
+		const CSR& g = adjlist->getCSR();
+
+		SpanningTree sequential = kruskal(g);
+		SpanningTree parallel = kruskal(g, &pool);
+		SpanningTree forest = boruvka(g, pool);
+
+		// a forest has one edge fewer than vertices in every tree
+		size_t tree_edges = adjlist->vertices - connectedComponents(g).count();
+		CHECK(sequential.edges.size() == tree_edges);
+		CHECK(parallel.edges.size() == tree_edges);
+		CHECK(forest.edges.size() == tree_edges);
+		CHECK(parallel.total_weight == sequential.total_weight);
+		CHECK(forest.total_weight == sequential.total_weight);
+
+		if (connected)
+		{
+			SpanningTree tree = prim(g, 0);
+			CHECK(tree.edges.size() == tree_edges);
+			CHECK(tree.total_weight == sequential.total_weight);
+		}
+
+		delete adjlist;
+	}
+}
+
+// connected components labelled sequentially against the parallel labelling, and against the
+// union-find AdjList keeps up to date as edges are added
+void testConnectedComponents()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		// about one edge per two vertices leaves many components of all sizes
+		size_t n = 500 + seed * 400;
+		AdjList* adjlist = new AdjList(n, seed % 2 == 0, false);
+
+		mt19937 rng(300 + seed);
+		for (size_t i = 0; i < n / 2; i++)
+		{
+			size_t u = rng() % n, v = rng() % n;
+			if (u != v)
+				adjlist->addEdge(u, v);
+		}
+		const CSR& g = adjlist->getCSR();
+
+		Components sequential = connectedComponents(g);
+		Components parallel = parallelConnectedComponents(g, pool);
+		CHECK(parallel.id == sequential.id);
+		CHECK(parallel.sizes == sequential.sizes);
+
+		for (size_t i = 0; i < 200; i++)
+		{
+			size_t u = rng() % n, v = rng() % n;
+			CHECK(adjlist->areConnected(u, v) == (sequential.id[u] == sequential.id[v]));
+		}
+
+		delete adjlist;
+	}
+}
+
+// Tarjan's strongly connected components against the parallel forward-backward ones,
+// and both against reachability found by BFS
+void testStronglyConnectedComponents()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		// around one edge per vertex the graph has a large component and many single vertices
+		size_t n = 300 + seed * 250;
+		AdjList* adjlist = randomGraph(n, n * (1 + seed % 3) / 2 + n / 4, true, false, 5, 400 + seed);
+		const CSR& g = adjlist->getCSR();
+		const CSR& in = adjlist->getReverseCSR();
+
+		Components sequential = tarjanSCC(g);
+		Components parallel = parallelSCC(g, in, pool);
+		CHECK(parallel.id == sequential.id);
+		CHECK(parallel.sizes == sequential.sizes);
+
+		// u and v share a component exactly when each reaches the other
+		mt19937 rng(500 + seed);
+		for (size_t i = 0; i < 20; i++)
+		{
+			size_t u = rng() % n;
+			if (!g.exists(u))
+				continue;
+
+			ShortestPaths from = bfs(g, in, u), to = bfs(in, g, u);
+			for (size_t v = 0; v < n; v++)
+				if (g.exists(v))
+					CHECK((sequential.id[u] == sequential.id[v]) == (from.dist[v] != UNREACHABLE && to.dist[v] != UNREACHABLE));
+		}
+
+		delete adjlist;
+	}
+}
+
+// the topological order AdjList keeps on every change must refuse exactly the edges that close a cycle,
+// found by checking before each addEdge() whether its head already reaches its tail
+void testDynamicTopologicalOrder()
+{
+	for (unsigned seed = 0; seed < 20; seed++)
+	{
+		mt19937 rng(600 + seed);
+		size_t n = 20 + rng() % 200;
+		AdjList adjlist(n, true, false);
+		CHECK(adjlist.keepTopologicalOrder(true) == GRAPH_OK);
+
+		size_t refused = 0;
+		for (size_t i = 0; i < 4 * n; i++)
+		{
+			size_t u = rng() % adjlist.list_counter, v = rng() % adjlist.list_counter;
+			if (u == v || adjlist.findListWithIndex(u) == nullptr || adjlist.findListWithIndex(v) == nullptr)
+				continue;
+
+			// some removals and new vertices in between, which the order has to follow
+			int change = rng() % 20;
+			if (change == 0)
+			{
+				adjlist.removeEdge(u, v);
+				continue;
+			}
+			if (change == 1)
+			{
+				adjlist.removeList(u);
+				continue;
+			}
+			if (change == 2)
+				adjlist.addList();
+
+			const CSR& g = adjlist.getCSR();
+			bool closes_cycle = bfs(g, adjlist.getReverseCSR(), v).dist[u] != UNREACHABLE;
+
+			GraphStatus status = adjlist.addEdge(u, v);
+			CHECK(status == (closes_cycle ? GRAPH_CYCLE : GRAPH_OK));
+			refused += closes_cycle;
+		}
+		CHECK(refused > 0);
+
+		// every edge goes forwards in the order, which holds every vertex once
+		vector<size_t> order = adjlist.CurrentTopologicalOrder();
+		const CSR& g = adjlist.getCSR();
+		vector<size_t> position(g.size(), SIZE_MAX);
+		for (size_t i = 0; i < order.size(); i++)
+			position[order[i]] = i;
+
+		CHECK(order.size() == adjlist.vertices);
+		for (size_t u = 0; u < g.size(); u++)
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				CHECK(position[u] < position[g.targets[e]]);
+	}
+
+	// a graph that already has a cycle can't start keeping an order
+	AdjList cyclic(3, true, false);
+	cyclic.addEdge(0, 1);
+	cyclic.addEdge(1, 2);
+	cyclic.addEdge(2, 0);
+	CHECK(cyclic.keepTopologicalOrder(true) == GRAPH_CYCLE);
+}
+
+// returns whether two CSRs hold the same rows, in the same order
+bool sameCSR(const CSR& a, const CSR& b)
+{
+	if (a.size() != b.size() || a.edgeCount() != b.edgeCount())
+		return false;
+
+	for (size_t u = 0; u < a.size(); u++)
+	{
+		if (a.exists(u) != b.exists(u) || a.degree(u) != b.degree(u))
+			return false;
+		for (size_t e = a.edgeBegin(u), f = b.edgeBegin(u); e < a.edgeEnd(u); e++, f++)
+			if (a.targets[e] != b.targets[f] || a.weights[e] != b.weights[f])
+				return false;
+	}
+	return true;
+}
+
+// saveBinary() then fromBinary() gives back the same graph, and damaged files are refused
+void testBinaryRoundTrip()
+{
+	const char* path = "graph_test.bin";
+	for (unsigned seed = 0; seed < 6; seed++)
+	{
+		// the last one has no vertices at all
+		size_t n = (seed == 5) ? 0 : 50 + seed * 200;
+		AdjList* adjlist = (n == 0) ? new AdjList(0, true, true)
+			: randomGraph(n, n * (1 + seed), seed % 2 == 0, seed % 3 != 0, 3, 700 + seed);
+		CHECK(adjlist->saveBinary(path) == GRAPH_OK);
+
+		CSRFileStatus status;
+		AdjList* loaded = AdjList::fromBinary(path, &status);
+		CHECK(status == CSR_FILE_OK);
+		if (loaded == nullptr)
+		{
+			delete adjlist;
+			continue;
+		}
+
+		CHECK(loaded->directed == adjlist->directed);
+		CHECK(loaded->weighted == adjlist->weighted);
+		CHECK(loaded->vertices == adjlist->vertices);
+		CHECK(loaded->edges == adjlist->edges);
+		CHECK(sameCSR(loaded->getCSR(), adjlist->getCSR()));
+
+		// the lists were rebuilt too, not only the mapped CSR
+		loaded->csr_valid = false;
+		CHECK(sameCSR(loaded->getCSR(), adjlist->getCSR()));
+
+		delete loaded;
+		delete adjlist;
+	}
+
+	// an edge to a vertex that doesn't exist, written over the first target
+	AdjList* adjlist = randomGraph(10, 20, true, false, 0, 750);
+	adjlist->saveBinary(path);
+	FILE* file = fopen(path, "r+b");
+	CHECK(file != nullptr);
+	if (file != nullptr)
+	{
+		size_t bad_target = 1000;
+		fseek(file, sizeof(CSRFileHeader) + sizeof(size_t) * 11, SEEK_SET);
+		fwrite(&bad_target, sizeof(size_t), 1, file);
+		fclose(file);
+
+		CSRFileStatus status;
+		CHECK(AdjList::fromBinary(path, &status) == nullptr);
+		CHECK(status == CSR_FILE_CORRUPT);
+	}
+	delete adjlist;
+
+	// a file cut short, which even a trusted open refuses
+	adjlist = randomGraph(10, 20, true, false, 0, 751);
+	adjlist->saveBinary(path);
+	CSR g;
+	CSRFileHeader header;
+	CHECK(mapCSRFile(path, g, header, true) == CSR_FILE_OK && sameCSR(g, adjlist->getCSR()));
+	filesystem::resize_file(path, filesystem::file_size(path) - 1);
+	CHECK(mapCSRFile(path, g, header) == CSR_FILE_CORRUPT);
+	CHECK(mapCSRFile(path, g, header, true) == CSR_FILE_CORRUPT);
+	delete adjlist;
+
+	// the undirected path 0 - 1 - 2, with the first target written over by 0 (a self loop),
+	// then by 2 (so 0 has an edge to 2 that 2 doesn't have back)
+	adjlist = new AdjList(3, false, false);
+	adjlist->addEdge(0, 1);
+	adjlist->addEdge(1, 2);
+	for (size_t bad_target : {0, 2})
+	{
+		adjlist->saveBinary(path);
+		file = fopen(path, "r+b");
+		CHECK(file != nullptr);
+		if (file == nullptr)
+			break;
+		fseek(file, sizeof(CSRFileHeader) + sizeof(size_t) * 4, SEEK_SET);
+		fwrite(&bad_target, sizeof(size_t), 1, file);
+		fclose(file);
+		CHECK(mapCSRFile(path, g, header) == CSR_FILE_CORRUPT);
+	}
+	delete adjlist;
+
+	remove(path);
+}
+
+// every row of g as a sorted list of (target, weight), so graphs whose lists are in different orders compare equal
+vector<vector<pair<size_t, size_t>>> sortedRows(const CSR& g)
+{
+	vector<vector<pair<size_t, size_t>>> rows(g.size());
+	for (size_t u = 0; u < g.size(); u++)
+	{
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			rows[u].emplace_back(g.targets[e], g.weights[e]);
+		sort(rows[u].begin(), rows[u].end());
+	}
+	return rows;
+}
+
+// writes g to path in the given format (an undirected edge once, as the formats expect),
+// with comments, blank lines and a line that isn't an edge at line bad_line (from 1)
+void writeTextGraph(const char* path, const CSR& g, GraphFileFormat format, bool directed, size_t& bad_line)
+{
+	FILE* file = fopen(path, "w");
+	size_t base = (format == FORMAT_EDGE_LIST) ? 0 : 1, line = 0;
+
+	size_t m = 0;
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			m += directed || u < g.targets[e];
+
+	if (format == FORMAT_MATRIX_MARKET)
+	{
+		fprintf(file, "%%%%MatrixMarket matrix coordinate integer %s\n%% test graph\n%zu %zu %zu\n",
+			directed ? "general" : "symmetric", g.size(), g.size(), m);
+		line = 3;
+	}
+	else if (format == FORMAT_DIMACS)
+	{
+		fprintf(file, "c test graph\np sp %zu %zu\n", g.size(), m);
+		line = 2;
+	}
+	else
+	{
+		fprintf(file, "# test graph\n\n");
+		line = 2;
+	}
+
+	const char* prefix = (format == FORMAT_DIMACS) ? "a " : "";
+	for (size_t u = 0; u < g.size(); u++)
+		for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+			if (directed || u < g.targets[e])
+			{
+				fprintf(file, "%s%zu %zu %zu\n", prefix, u + base, g.targets[e] + base, g.weights[e]);
+				if (++line == 40)
+				{
+					fprintf(file, "%s%zu %zu %zu extra\n", prefix, u + base, g.targets[e] + base, g.weights[e]);
+					bad_line = ++line;
+				}
+			}
+	fclose(file);
+}
+
+// each text format read back into the graph it was written from, parsed on one thread and on several
+void testTextImport()
+{
+	const char* path = "graph_test.txt";
+	ThreadPool one(1), pool(TEST_THREADS);
+
+	for (unsigned seed = 0; seed < 6; seed++)
+	{
+		GraphFileFormat format = (GraphFileFormat)(seed % 3);
+		bool directed = (format == FORMAT_DIMACS) || seed < 3;
+
+		// big enough for the file to be split into several chunks
+		size_t n = 3000 + seed * 500;
+		AdjList* adjlist = randomGraph(n, 4 * n, directed, true, 0, 800 + seed);
+		adjlist->addEdge(n - 2, n - 1, 1);
+		const CSR& g = adjlist->getCSR();
+
+		size_t bad_line = 0;
+		writeTextGraph(path, g, format, directed, bad_line);
+
+		ImportedGraph sequential, parallel;
+		CHECK(importGraph(path, format, directed, one, sequential));
+		CHECK(importGraph(path, format, directed, pool, parallel));
+		CHECK(parallel.edges == sequential.edges);
+		CHECK(parallel.vertices == n && sequential.vertices == n);
+		CHECK(parallel.report.bad_lines == 1 && parallel.report.first_bad_line == bad_line);
+		CHECK(sequential.report.first_bad_line == bad_line);
+
+		ImportReport report;
+		AdjList* imported = AdjList::fromText(path, format, directed, &report);
+		CHECK(imported != nullptr);
+		if (imported != nullptr)
+		{
+			CHECK(imported->directed == directed);
+			CHECK(imported->vertices == n);
+			// the bad line repeats an edge, so the graph has it once
+			CHECK(imported->edges == adjlist->edges);
+			CHECK(sortedRows(imported->getCSR()) == sortedRows(g));
+			CHECK(report.bad_lines == 1 && report.original_id.empty());
+		}
+
+		delete imported;
+		delete adjlist;
+	}
+
+	// ids far apart are renumbered in increasing order
+	FILE* file = fopen(path, "w");
+	fprintf(file, "4000000000 17\n17 3000000000\n99 4000000000\n");
+	fclose(file);
+	ImportReport report;
+	AdjList* sparse = AdjList::fromText(path, FORMAT_EDGE_LIST, true, &report);
+	CHECK(sparse != nullptr && sparse->vertices == 4 && sparse->edges == 3);
+	CHECK(report.original_id == vector<size_t>({17, 99, 3000000000, 4000000000}));
+	CHECK(sparse != nullptr && sparse->hasEdge(3, 0) && sparse->hasEdge(0, 2) && sparse->hasEdge(1, 3));
+	delete sparse;
+
+	// ids are whole numbers, and weights are kept exactly or not at all
+	file = fopen(path, "w");
+	fprintf(file, "0 1 3.0\n1 2 1e3\n1.5 2 3\n2 3 0.2\n3 4 1e30\n4 5 -2\n5 6 0\n6 7 99999999999999999999999\n7 8 x\n");
+	fclose(file);
+	report = ImportReport{};
+	AdjList* weights = AdjList::fromText(path, FORMAT_EDGE_LIST, true, &report);
+	CHECK(weights != nullptr && weights->edges == 2);
+	CHECK(report.bad_lines == 2 && report.first_bad_line == 3 && report.bad_weights == 5 && report.self_loops == 0);
+	CHECK(weights != nullptr && weights->edgeWeight(0, 1) == 3 && weights->edgeWeight(1, 2) == 1000);
+	delete weights;
+
+	// an empty file is an empty graph
+	fclose(fopen(path, "w"));
+	AdjList* empty = AdjList::fromText(path, FORMAT_MATRIX_MARKET, true);
+	CHECK(empty != nullptr && empty->vertices == 0 && empty->edges == 0);
+	delete empty;
+
+	remove(path);
+}
+
+// removeList() one vertex at a time, with and without in-edges kept, and removeLists() on the same vertices,
+// against the edges of the graph before that don't touch a removed vertex
+void testVertexRemoval()
+{
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		bool directed = seed % 2 == 0;
+		// few vertices for many edges, so there are plenty of parallel edges
+		size_t n = 30 + seed * 10;
+		AdjList* graphs[3];
+		for (AdjList*& adjlist : graphs)
+		{
+			adjlist = randomGraph(n, n * (4 + seed % 3), directed, true, 0, 900 + seed);
+			for (size_t u = 0; u + 1 < n; u += 5)
+			{
+				adjlist->addEdge(u, u + 1, 3);
+				adjlist->addEdge(u, u + 1, 4);
+			}
+		}
+		AdjList* scan = graphs[0];
+		AdjList* neighbours = graphs[1];
+		AdjList* batch = graphs[2];
+		neighbours->keepInEdges(true);
+		vector<vector<pair<size_t, size_t>>> before = sortedRows(scan->getCSR());
+
+		mt19937 rng(950 + seed);
+		vector<size_t> doomed;
+		vector<bool> removed(n, false);
+		for (size_t i = 0; i < n / 3; i++)
+		{
+			size_t u = rng() % n;
+			doomed.push_back(u);
+			GraphStatus expected = removed[u] ? GRAPH_NO_SUCH_VERTEX : GRAPH_OK;
+			CHECK(scan->removeList(u) == expected);
+			CHECK(neighbours->removeList(u) == expected);
+			removed[u] = true;
+		}
+		// repeated indices are removed once, and one past the end is reported
+		doomed.push_back(n);
+		CHECK(batch->removeLists(doomed) == GRAPH_NO_SUCH_VERTEX);
+
+		// what is left of the graph before
+		vector<vector<pair<size_t, size_t>>> after(n);
+		size_t vertices = 0, stored = 0;
+		for (size_t u = 0; u < n; u++)
+			if (!removed[u])
+			{
+				vertices++;
+				for (const pair<size_t, size_t>& edge : before[u])
+					if (!removed[edge.first])
+						after[u].push_back(edge);
+				stored += after[u].size();
+			}
+		size_t edges = directed ? stored : stored / 2;
+
+		for (AdjList* adjlist : graphs)
+		{
+			const CSR& g = adjlist->getCSR();
+			CHECK(adjlist->vertices == vertices && adjlist->edges == edges);
+			CHECK(g.edgeCount() == stored);
+			CHECK(sortedRows(g) == after);
+			for (size_t u = 0; u < n; u++)
+				CHECK(g.exists(u) == !removed[u]);
+			delete adjlist;
+		}
+	}
+}
+
+// the rows of a CompressedCSR read back through its Cursor, and bfs() and CompressedDFS on it against the CSR it was made from
+void testCompressedCSR()
+{
+	for (unsigned seed = 0; seed < 6; seed++)
+	{
+		bool directed = seed % 2 == 0;
+		size_t n = 200 + seed * 150;
+		// large weights and far apart neighbours take varints of several bytes
+		AdjList* adjlist = randomGraph(n, n * (1 + seed % 3), directed, true, 4, 1000 + seed);
+		adjlist->addEdge(0, n - 1, 100000);
+		const CSR& g = adjlist->getCSR();
+		CSR in = directed ? g.reversed() : g;
+		CompressedCSR compressed(g, true), compressed_in(in, false);
+
+		CHECK(compressed.size() == g.size() && compressed.edgeCount() == g.edgeCount());
+		vector<vector<pair<size_t, size_t>>> rows(n);
+		for (size_t u = 0; u < n; u++)
+		{
+			CHECK(compressed.exists(u) == g.exists(u) && compressed.degree(u) == g.degree(u));
+			for (CompressedCSR::Cursor c = compressed.row(u); c.next(); )
+				rows[u].emplace_back(c.vertex, c.weight());
+		}
+		CHECK(rows == sortedRows(g));
+
+		DFS dfs(g);
+		CompressedDFS compressed_dfs(compressed);
+		for (size_t source = 0; source < n; source += n / 7)
+		{
+			CHECK(bfs(compressed, compressed_in, source).dist == bfs(g, in, source).dist);
+
+			// the rows are in different orders, so only what is reached is the same
+			vector<size_t> reached, compressed_reached;
+			dfs.reset();
+			compressed_dfs.reset();
+			if (g.exists(source))
+			{
+				dfs.run(source, DFSNoPreHook(), [&](size_t u) { reached.push_back(u); return false; }, DFSNoHook());
+				compressed_dfs.run(source, DFSNoPreHook(), [&](size_t u) { compressed_reached.push_back(u); return false; }, DFSNoHook());
+			}
+			sort(reached.begin(), reached.end());
+			sort(compressed_reached.begin(), compressed_reached.end());
+			CHECK(reached == compressed_reached);
+		}
+
+		delete adjlist;
+	}
+}
+
+// every simple path from u to target as (vertices, length), weight[u][v] = the lightest edge (u, v)
+void allSimplePaths(const vector<vector<size_t>>& weight, size_t u, size_t target, vector<size_t>& path, size_t length,
+	vector<bool>& on_path, vector<pair<vector<size_t>, size_t>>& paths)
+{
+	path.push_back(u);
+	on_path[u] = true;
+	if (u == target)
+		paths.emplace_back(path, length);
+	else
+		for (size_t v = 0; v < weight.size(); v++)
+			if (weight[u][v] != UNREACHABLE && !on_path[v])
+				allSimplePaths(weight, v, target, path, length + weight[u][v], on_path, paths);
+	on_path[u] = false;
+	path.pop_back();
+}
+
+// EnumeratePaths() and KShortestPaths() on small graphs with parallel edges, against every simple path tried by hand
+void testPaths()
+{
+	for (unsigned seed = 0; seed < 10; seed++)
+	{
+		bool directed = seed % 2 == 0;
+		size_t n = 6 + seed % 4;
+		AdjList* adjlist = randomGraph(n, n * (2 + seed % 3), directed, true, seed % 3 == 0, 1100 + seed);
+
+		// a heavier copy of the first edge of every row
+		CSR before = adjlist->getCSR();
+		for (size_t u = 0; u < n; u++)
+			if (before.degree(u) != 0)
+				adjlist->addEdge(u, before.targets[before.edgeBegin(u)], before.weights[before.edgeBegin(u)] + 1);
+
+		const CSR& g = adjlist->getCSR();
+		vector<vector<size_t>> weight(n, vector<size_t>(n, UNREACHABLE));
+		for (size_t u = 0; u < n; u++)
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				weight[u][g.targets[e]] = min(weight[u][g.targets[e]], g.weights[e]);
+
+		for (size_t source = 0; source < n; source++)
+			for (size_t target = 0; target < n; target++)
+			{
+				if (source == target)
+					continue;
+
+				vector<pair<vector<size_t>, size_t>> paths;
+				vector<size_t> path;
+				vector<bool> on_path(n, false);
+				allSimplePaths(weight, source, target, path, 0, on_path, paths);
+
+				vector<vector<size_t>> expected, short_expected;
+				vector<size_t> lengths;
+				for (const pair<vector<size_t>, size_t>& p : paths)
+				{
+					expected.push_back(p.first);
+					if (p.first.size() <= 3)
+						short_expected.push_back(p.first);
+					lengths.push_back(p.second);
+				}
+				sort(expected.begin(), expected.end());
+				sort(short_expected.begin(), short_expected.end());
+				sort(lengths.begin(), lengths.end());
+
+				// every path once, whichever of the parallel edges it could take
+				vector<vector<size_t>> found;
+				PathLimits limits;
+				auto collect = [&](const vector<size_t>& p) { found.push_back(p); return false; };
+				CHECK(adjlist->EnumeratePaths(source, target, limits, collect) == PATHS_ALL);
+				sort(found.begin(), found.end());
+				CHECK(found == expected);
+
+				// at most two edges
+				found.clear();
+				limits.max_edges = 2;
+				CHECK(adjlist->EnumeratePaths(source, target, limits, collect) == PATHS_ALL);
+				sort(found.begin(), found.end());
+				CHECK(found == short_expected);
+
+				// at most three paths, all different and all real
+				found.clear();
+				limits = PathLimits();
+				limits.max_paths = 3;
+				PathsEnd end = adjlist->EnumeratePaths(source, target, limits, collect);
+				CHECK(end == (expected.size() >= 3 ? PATHS_MAX_PATHS : PATHS_ALL));
+				CHECK(found.size() == min(expected.size(), (size_t)3));
+				sort(found.begin(), found.end());
+				CHECK(adjacent_find(found.begin(), found.end()) == found.end());
+				for (const vector<size_t>& p : found)
+					CHECK(binary_search(expected.begin(), expected.end(), p));
+
+				// the k shortest are the lightest of all of them, shortest first
+				vector<WeightedPath> shortest = adjlist->KShortestPaths(source, target, 5);
+				CHECK(shortest.size() == min(lengths.size(), (size_t)5));
+				for (size_t i = 0; i < shortest.size() && i < lengths.size(); i++)
+				{
+					CHECK(shortest[i].length == lengths[i]);
+					CHECK(binary_search(expected.begin(), expected.end(), shortest[i].vertices));
+				}
+			}
+
+		delete adjlist;
+	}
+}
+
+// random addEdge() and removeEdge() calls around one vertex whose list grows past LIST_INDEX_THRESHOLD and shrinks again,
+// with parallel edges, checked against edge counts kept by hand after every step
+void testEdgeLookup()
+{
+	for (bool directed : {true, false})
+	{
+		size_t n = 3 * LIST_INDEX_THRESHOLD;
+		AdjList adjlist(n, directed, true);
+		mt19937 rng(directed ? 1200 : 1201);
+
+		// count[u][v] = copies of edge (u, v), both ways round for an undirected edge, all of weight weightOf(u, v)
+		vector<vector<size_t>> count(n, vector<size_t>(n, 0));
+		auto weightOf = [&](size_t u, size_t v) { return directed ? 1 + u * n + v : 1 + min(u, v) * n + max(u, v); };
+		size_t edges = 0;
+
+		for (size_t step = 0; step < 3000; step++)
+		{
+			// mostly edges of vertex 0, added more often at first so its list grows, then removed more often
+			size_t u = (rng() % 4 == 0) ? rng() % n : 0;
+			size_t v = rng() % n;
+			if (u == v)
+				continue;
+
+			bool add = rng() % 100 < (step < 1500 ? 70u : 30u);
+			if (add)
+			{
+				CHECK(adjlist.addEdge(u, v, weightOf(u, v)) == GRAPH_OK);
+				count[u][v]++;
+				if (!directed)
+					count[v][u]++;
+				edges++;
+			}
+			else
+			{
+				CHECK(adjlist.removeEdge(u, v) == (count[u][v] != 0 ? GRAPH_OK : GRAPH_NO_SUCH_EDGE));
+				if (count[u][v] != 0)
+				{
+					count[u][v]--;
+					if (!directed)
+						count[v][u]--;
+					edges--;
+				}
+			}
+
+			CHECK(adjlist.edges == edges);
+			for (size_t w = 0; w < n; w++)
+				for (size_t x : {u, v})
+				{
+					CHECK(adjlist.hasEdge(x, w) == (count[x][w] != 0));
+					CHECK(adjlist.edgeWeight(x, w) == (count[x][w] != 0 ? weightOf(x, w) : UNREACHABLE));
+				}
+
+			if (step % 100 == 0)
+			{
+				const CSR& g = adjlist.getCSR();
+				CHECK(g.edgeCount() == (directed ? edges : 2 * edges));
+				for (size_t x = 0; x < n; x++)
+				{
+					vector<size_t> row(n, 0);
+					for (size_t e = g.edgeBegin(x); e < g.edgeEnd(x); e++)
+						row[g.targets[e]]++;
+					CHECK(row == count[x]);
+				}
+			}
+		}
+		CHECK(adjlist.getCSR().edgeCount() == (directed ? edges : 2 * edges));
+
+		// without parallel edges, a second copy is refused whichever way round it is given, on long and short lists
+		AdjList simple(n, directed, false);
+		simple.allow_parallel_edges = false;
+		for (size_t v = 1; v < n; v++)
+			CHECK(simple.addEdge(0, v) == GRAPH_OK);
+		CHECK(simple.addEdge(1, 2) == GRAPH_OK);
+		CHECK(simple.addEdge(0, n - 1) == GRAPH_DUPLICATE_EDGE);
+		CHECK(simple.addEdge(1, 2) == GRAPH_DUPLICATE_EDGE);
+		CHECK(simple.addEdge(n - 1, 0) == (directed ? GRAPH_OK : GRAPH_DUPLICATE_EDGE));
+		CHECK(simple.addEdge(2, 1) == (directed ? GRAPH_OK : GRAPH_DUPLICATE_EDGE));
+		CHECK(simple.edges == (directed ? n + 2 : n));
+		CHECK(simple.removeEdge(0, 5) == GRAPH_OK && !simple.hasEdge(0, 5));
+		CHECK(simple.addEdge(0, 5) == GRAPH_OK && simple.hasEdge(0, 5));
+	}
+}
+
+// Kahn's algorithm on a pool against the sequential run, on graphs without cycles (the waves have to follow the longest
+// paths into every vertex) and with one (the cycle it returns has to be made of real edges)
+void testKahnTopologicalSort()
+{
+	ThreadPool pool(TEST_THREADS);
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		size_t n = 500 + seed * 700;
+		mt19937 rng(1300 + seed);
+
+		// edges only go forward in a shuffled order of the vertices, many of them parallel
+		vector<size_t> rank(n);
+		for (size_t v = 0; v < n; v++)
+			rank[v] = v;
+		shuffle(rank.begin(), rank.end(), rng);
+		AdjList adjlist(n, true, false);
+		for (size_t i = 0; i < 3 * n; i++)
+		{
+			size_t a = rng() % n, b = rng() % n;
+			if (a != b)
+				adjlist.addEdge(rank[min(a, b)], rank[max(a, b)]);
+			if (i % 7 == 0 && a != b)
+				adjlist.addEdge(rank[min(a, b)], rank[max(a, b)]);
+		}
+		for (size_t i = 0; i < 5; i++)
+			adjlist.removeList(rng() % n);
+
+		bool cyclic = seed % 2 == 1;
+		if (cyclic)
+		{
+			// an edge back from the end of a long path to its start
+			const CSR& g = adjlist.getCSR();
+			size_t first = 0;
+			while (!g.exists(first) || g.degree(first) == 0)
+				first++;
+			size_t last = first;
+			while (g.degree(last) != 0)
+				last = g.targets[g.edgeBegin(last)];
+			adjlist.addEdge(last, first);
+		}
+
+		const CSR& g = adjlist.getCSR();
+		TopologicalOrder sequential = kahnTopologicalSort(g);
+		TopologicalOrder parallel = kahnTopologicalSort(g, &pool);
+		CHECK(parallel.acyclic == sequential.acyclic && sequential.acyclic == !cyclic);
+		CHECK(parallel.order == sequential.order);
+		CHECK(parallel.wave_start == sequential.wave_start);
+		CHECK(parallel.cycle == sequential.cycle);
+
+		// the wave of every placed vertex, which has to be the longest path into it
+		vector<size_t> wave(n, SIZE_MAX);
+		for (size_t w = 0; w < sequential.waves(); w++)
+		{
+			CHECK(sequential.wave_start[w] < sequential.wave_start[w + 1]);
+			CHECK(is_sorted(sequential.order.begin() + sequential.wave_start[w], sequential.order.begin() + sequential.wave_start[w + 1]));
+			for (size_t i = sequential.wave_start[w]; i < sequential.wave_start[w + 1]; i++)
+				wave[sequential.order[i]] = w;
+		}
+		CHECK(sequential.wave_start.back() == sequential.order.size());
+
+		vector<size_t> longest(n, 0);
+		for (size_t u : sequential.order)
+		{
+			CHECK(longest[u] == wave[u]);
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				longest[g.targets[e]] = max(longest[g.targets[e]], wave[u] + 1);
+		}
+
+		// every edge into a placed vertex comes from an earlier wave, and every vertex left out depends on the cycle
+		size_t placed = 0;
+		for (size_t u = 0; u < n; u++)
+		{
+			placed += g.exists(u) && wave[u] != SIZE_MAX;
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				if (wave[g.targets[e]] != SIZE_MAX)
+					CHECK(wave[u] < wave[g.targets[e]]);
+		}
+		CHECK(placed == sequential.order.size());
+		CHECK((placed == adjlist.vertices) == !cyclic);
+
+		if (cyclic)
+		{
+			const vector<size_t>& cycle = sequential.cycle;
+			CHECK(cycle.size() >= 2);
+			vector<size_t> distinct(cycle);
+			sort(distinct.begin(), distinct.end());
+			CHECK(adjacent_find(distinct.begin(), distinct.end()) == distinct.end());
+			for (size_t i = 0; i < cycle.size(); i++)
+			{
+				CHECK(wave[cycle[i]] == SIZE_MAX);
+				CHECK(adjlist.hasEdge(cycle[i], cycle[(i + 1) % cycle.size()]));
+			}
+		}
+	}
+}
+
+// single-source Dijkstra with the binary heap and with the radix heap, against each other and the Floyd-Warshall rows
+void testDijkstra()
+{
+	for (unsigned seed = 0; seed < 8; seed++)
+	{
+		size_t n = 30 + seed * 40;
+		AdjList* adjlist = randomGraph(n, n * (1 + seed % 4), seed % 2 == 0, true, seed % 3, 1400 + seed);
+
+		// some heavy edges, so distances spread over many radix heap buckets
+		mt19937 rng(1450 + seed);
+		for (size_t i = 0; i < n; i++)
+			adjlist->addEdge(rng() % n, rng() % n, 1 + rng() % 1000000);
+
+		const CSR& g = adjlist->getCSR();
+		AllPairsPaths all = floydWarshall(g);
+		for (size_t source = 0; source < n; source++)
+		{
+			if (!g.exists(source))
+				continue;
+
+			ShortestPaths binary = dijkstra(g, source, false);
+			ShortestPaths radix = dijkstra(g, source, true);
+			CHECK(binary.dist == radix.dist);
+			CHECK(binary.dist[source] == 0);
+			for (size_t v = 0; v < n; v++)
+			{
+				if (v != source)
+				{
+					size_t expected = all.dist[source * n + v];
+					CHECK(binary.dist[v] == (expected == NO_PATH ? UNREACHABLE : expected));
+				}
+
+				// the parent of every reached vertex ends a shortest path to it
+				for (const ShortestPaths& sp : {binary, radix})
+					if (v != source && sp.dist[v] != UNREACHABLE)
+					{
+						size_t p = sp.parent[v], lightest = UNREACHABLE;
+						for (size_t e = g.edgeBegin(p); e < g.edgeEnd(p); e++)
+							if (g.targets[e] == v)
+								lightest = min(lightest, g.weights[e]);
+						CHECK(lightest != UNREACHABLE && sp.dist[p] + lightest == sp.dist[v]);
+					}
+			}
+		}
+
+		delete adjlist;
+	}
+}
+
+// builds the same graph as a Graph<uint32_t, Weight, Directed> and as an AdjList, removes the same vertices from both,
+// and compares their counts, toCSR() and BFS() after every removal
+template <class Weight, bool Directed>
+void compareTypedGraph(size_t n, size_t edge_count, unsigned seed)
+{
+	mt19937 rng(seed);
+	vector<tuple<size_t, size_t, size_t>> edge_list;
+	for (size_t i = 0; i < edge_count; i++)
+	{
+		size_t u = rng() % n, v = rng() % n;
+		// every 20th weight is 0, which both graphs take as 1 (and some edges are parallel)
+		size_t weight = (i % 20 == 0) ? 0 : 1 + rng() % 1000;
+		edge_list.emplace_back(u, v, weight);
+		if (i % 9 == 0)
+			edge_list.emplace_back(u, v, weight + 1);
+	}
+
+	Graph<uint32_t, Weight, Directed> typed(n);
+	AdjList adjlist(n, Directed, Graph<uint32_t, Weight, Directed>::weighted);
+	CHECK(typed.addEdges(edge_list) == adjlist.addEdges(edge_list));
+
+	for (size_t step = 0; step < 6; step++)
+	{
+		CHECK(typed.vertices == adjlist.vertices && typed.edges == adjlist.edges);
+		CSR g = typed.toCSR();
+		CHECK(g.edgeCount() == (Directed ? typed.edges : 2 * typed.edges));
+		CHECK(sortedRows(g) == sortedRows(adjlist.getCSR()));
+		for (size_t e = 0; e < g.edgeCount(); e++)
+			CHECK(g.weights[e] >= 1);
+
+		for (size_t source = step; source < n; source += n / 3)
+			CHECK(typed.BFS(source).dist == adjlist.BFS(source).dist);
+
+		size_t u = rng() % n;
+		CHECK(typed.removeVertex(u) == adjlist.removeList(u));
+	}
+}
+
+// Graph<VertexId, Weight, Directed> against an AdjList holding the same edges
+void testTypedGraph()
+{
+	for (unsigned seed = 0; seed < 4; seed++)
+	{
+		size_t n = 100 + seed * 300;
+		compareTypedGraph<NoWeight, true>(n, 4 * n, 1500 + seed);
+		compareTypedGraph<uint16_t, false>(n, 3 * n, 1550 + seed);
+	}
+
+	// a weight that isn't positive is taken as 1
+	Graph<uint32_t, uint16_t, false> small(3);
+	small.addEdge(0, 1, 0);
+	small.addEdge(1, 2, 7);
+	vector<vector<pair<size_t, size_t>>> expected = {{{1, 1}}, {{0, 1}, {2, 7}}, {{1, 7}}};
+	CHECK(sortedRows(small.toCSR()) == expected);
+
+	Graph<uint32_t, int, true> negative(2);
+	negative.addEdge(0, 1, -5);
+	CHECK(negative.toCSR().weights[0] == 1);
+}
+
+// Reordered() copies with RCM and degree order, mapped back through original_id, against the graph they were made from
+void testReordering()
+{
+	for (unsigned seed = 0; seed < 6; seed++)
+	{
+		bool directed = seed % 2 == 0;
+		size_t n = 100 + seed * 200;
+		AdjList* adjlist = randomGraph(n, n * (2 + seed % 3), directed, true, 10, 1600 + seed);
+
+		// parallel copies of some edges
+		CSR before = adjlist->getCSR();
+		for (size_t u = 0; u < n; u += 7)
+			if (before.degree(u) != 0)
+				adjlist->addEdge(u, before.targets[before.edgeBegin(u)], 5);
+
+		const CSR& g = adjlist->getCSR();
+		vector<tuple<size_t, size_t, size_t>> edges;
+		for (size_t u = 0; u < n; u++)
+			for (size_t e = g.edgeBegin(u); e < g.edgeEnd(u); e++)
+				edges.emplace_back(u, g.targets[e], g.weights[e]);
+		sort(edges.begin(), edges.end());
+
+		for (VertexOrdering method : {ORDER_RCM, ORDER_DEGREE})
+		{
+			vector<size_t> original_id;
+			AdjList* copy = adjlist->Reordered(method, original_id);
+			CHECK(copy->vertices == adjlist->vertices && copy->edges == adjlist->edges);
+			CHECK(copy->directed == directed && copy->weighted);
+
+			// every vertex of the graph once, and none of the removed ones
+			vector<size_t> sorted(original_id);
+			sort(sorted.begin(), sorted.end());
+			CHECK(sorted.size() == adjlist->vertices);
+			CHECK(adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+			for (size_t u : sorted)
+				CHECK(g.exists(u));
+
+			const CSR& relabelled = copy->getCSR();
+			vector<tuple<size_t, size_t, size_t>> mapped;
+			for (size_t u = 0; u < relabelled.size(); u++)
+				for (size_t e = relabelled.edgeBegin(u); e < relabelled.edgeEnd(u); e++)
+					mapped.emplace_back(original_id[u], original_id[relabelled.targets[e]], relabelled.weights[e]);
+			sort(mapped.begin(), mapped.end());
+			CHECK(mapped == edges);
+
+			delete copy;
+		}
+
+		delete adjlist;
+	}
+}
+
+// several threads running parallelFor() on one pool at the same time, each has to get its own range done exactly once
+void testThreadPool()
+{
+	ThreadPool pool(TEST_THREADS);
+	vector<size_t> sums(6, 0);
+	vector<thread> callers;
+	for (size_t t = 0; t < sums.size(); t++)
+		callers.emplace_back([&, t]()
+		{
+			for (size_t round = 0; round < 50; round++)
+			{
+				size_t n = 1000 + 100 * t;
+				atomic<size_t> sum(0);
+				vector<unsigned char> seen(n, 0);
+				pool.parallelFor(0, n, 7, [&](size_t lo, size_t hi, size_t)
+				{
+					for (size_t i = lo; i < hi; i++)
+					{
+						seen[i]++;
+						sum.fetch_add(i + t, memory_order_relaxed);
+					}
+				});
+				if (count(seen.begin(), seen.end(), 1) == (ptrdiff_t)n)
+					sums[t] += sum;
+			}
+		});
+	for (thread& caller : callers)
+		caller.join();
+
+	for (size_t t = 0; t < sums.size(); t++)
+	{
+		size_t n = 1000 + 100 * t;
+		CHECK(sums[t] == 50 * (n * (n - 1) / 2 + n * t));
+	}
+}
+
+struct Test
+{
+	const char* name;
+	void (*run)();
+};
+
+const Test tests[] =
+{
+	{"floyd_warshall", testFloydWarshall},
+	{"parallel_bfs", testParallelBFS},
+	{"spanning_trees", testSpanningTrees},
+	{"connected_components", testConnectedComponents},
+	{"strongly_connected_components", testStronglyConnectedComponents},
+	{"dynamic_topological_order", testDynamicTopologicalOrder},
+	{"binary_round_trip", testBinaryRoundTrip},
+	{"text_import", testTextImport},
+	{"vertex_removal", testVertexRemoval},
+	{"compressed_csr", testCompressedCSR},
+	{"paths", testPaths},
+	{"edge_lookup", testEdgeLookup},
+	{"topological_sort", testKahnTopologicalSort},
+	{"dijkstra", testDijkstra},
+	{"typed_graph", testTypedGraph},
+	{"reordering", testReordering},
+	{"thread_pool", testThreadPool},
+};
+
+int main(int argc, char** argv)
+{
+	bool ran = false;
+	for (const Test& test : tests)
+		if (argc < 2 || strcmp(argv[1], test.name) == 0)
+		{
+			printf("%s\n", test.name);
+			test.run();
+			ran = true;
+		}
+
+	if (!ran)
+	{
+		printf("no test called %s\n", argv[1]);
+		return 1;
+	}
+
+	if (failures != 0)
+		printf("%d checks failed\n", failures);
+	return (failures == 0) ? 0 : 1;
+}